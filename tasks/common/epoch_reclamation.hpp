@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+
+class TooManyThreadsException : public std::exception {
+public:
+    explicit TooManyThreadsException(const std::string& text) : error_message_(text) {
+    }
+
+    const char* what() const noexcept override {
+        return error_message_.c_str();
+    }
+
+private:
+    std::string error_message_;
+};
+
+// Process-wide numbering of the threads that use concurrent containers.
+// A thread keeps its number until it exits, then the number is reused
+class ThreadSlots {
+public:
+    static constexpr size_t MaxThreads = 256;
+
+    static size_t Current() {
+        thread_local Registration registration;
+        return registration.index_;
+    }
+
+private:
+    static inline std::atomic<bool> taken_[MaxThreads] = {};
+
+    struct Registration {
+        size_t index_;
+
+        Registration() : index_(MaxThreads) {
+            for (size_t i = 0; i < MaxThreads; ++i) {
+                bool expected = false;
+                if (!taken_[i].load(std::memory_order_relaxed) &&
+                    taken_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    index_ = i;
+                    return;
+                }
+            }
+            throw TooManyThreadsException("All thread slots are taken");
+        }
+
+        ~Registration() {
+            taken_[index_].store(false, std::memory_order_release);
+        }
+    };
+};
+
+// Epoch based reclamation of the nodes of one container: a thread announces the
+// global epoch while it holds a Guard, and a node retired in epoch e is freed once
+// the global epoch reaches e + 2, when no thread can still hold a pointer to it.
+// Node provides Node* retired_next_ and uint64_t retired_epoch_ for the retired list
+template <typename Node, typename Reclaim = std::default_delete<Node>>
+class EpochDomain {
+private:
+    struct alignas(64) ThreadState {
+        // Epoch announced by the thread, Idle while it holds no guard
+        std::atomic<uint64_t> epoch_{Idle};
+        // Owned by the thread holding the slot
+        size_t guards_ = 0;
+        Node* retired_ = nullptr;
+        size_t retired_count_ = 0;
+    };
+
+public:
+    // Pins the calling thread to the current epoch for the scope. Guards nest, so an
+    // operation can run while the same thread holds a view or is inside a visitor
+    class Guard {
+    public:
+        explicit Guard(const EpochDomain& domain) : state_(domain.threads_[ThreadSlots::Current()]) {
+            if (state_.guards_++ == 0) {
+                state_.epoch_.store(domain.epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard() {
+            if (--state_.guards_ == 0) {
+                state_.epoch_.store(Idle, std::memory_order_release);
+            }
+        }
+
+    private:
+        friend class EpochDomain;
+
+        ThreadState& state_;
+    };
+
+    EpochDomain() : epoch_(0) {
+    }
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // Frees node once it is safe. The node must already be unreachable for new operations
+    void Retire(Node* node, const Guard& guard) {
+        ThreadState& state = guard.state_;
+        // Read after the unlink: a thread that could still see the node has announced
+        // at least this epoch - 1, so the epoch cannot pass this epoch + 1 before it leaves
+        node->retired_epoch_ = epoch_.load(std::memory_order_seq_cst);
+        node->retired_next_ = state.retired_;
+        state.retired_ = node;
+        if (++state.retired_count_ >= RetireBatch) {
+            TryAdvanceEpoch();
+            FreeRetired(state, epoch_.load(std::memory_order_acquire));
+        }
+    }
+
+    // Must not run concurrently with other operations
+    ~EpochDomain() {
+        for (auto& state : threads_) {
+            FreeRetired(state, FreeAll);
+        }
+    }
+
+private:
+    static constexpr uint64_t Idle = UINT64_MAX;
+    static constexpr uint64_t FreeAll = UINT64_MAX;
+    static constexpr size_t RetireBatch = 64;
+
+    alignas(64) std::atomic<uint64_t> epoch_;
+    mutable ThreadState threads_[ThreadSlots::MaxThreads];
+    [[no_unique_address]] Reclaim reclaim_;
+
+    // The epoch moves on only when every pinned thread has seen the current one
+    void TryAdvanceEpoch() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t current = epoch_.load(std::memory_order_relaxed);
+        for (const auto& state : threads_) {
+            uint64_t announced = state.epoch_.load(std::memory_order_acquire);
+            if (announced != Idle && announced != current) {
+                return;
+            }
+        }
+        epoch_.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+    }
+
+    void FreeRetired(ThreadState& state, uint64_t epoch) noexcept {
+        Node** link = &state.retired_;
+        while (Node* node = *link) {
+            if (epoch == FreeAll || node->retired_epoch_ + 2 <= epoch) {
+                *link = node->retired_next_;
+                reclaim_(node);
+                --state.retired_count_;
+            } else {
+                link = &node->retired_next_;
+            }
+        }
+    }
+};
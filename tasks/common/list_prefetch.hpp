@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+// Iterator over a linked list that requests the node after the next one while the caller
+// works on the current element, hiding part of the miss latency when nodes are scattered in
+// memory. Iterator exposes the address to request through a protected NextNode()
+template <typename Iterator>
+class PrefetchIterator : public Iterator {
+public:
+    PrefetchIterator() = default;
+
+    explicit PrefetchIterator(const Iterator& it) : Iterator(it) {
+        __builtin_prefetch(this->NextNode());
+    }
+
+    PrefetchIterator& operator++() {
+        Iterator::operator++();
+        __builtin_prefetch(this->NextNode());
+        return *this;
+    }
+
+    PrefetchIterator operator++(int) {
+        PrefetchIterator temp = *this;
+        ++(*this);
+        return temp;
+    }
+};
+
+// Looks up all values in a single walk over [first, last): results[i] becomes the first
+// element equal to values[i] or last. Each node is compared against every pending value,
+// which is cheap next to the cache miss of loading the node.
+// Returns the number of values found
+template <typename Iterator, typename T>
+size_t FindManyInRange(Iterator first, Iterator last, std::span<const T> values, std::span<Iterator> results) {
+    size_t count = std::min(values.size(), results.size());
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = last;
+    }
+    size_t pending = count;
+    for (PrefetchIterator<Iterator> it(first); it != last && pending > 0; ++it) {
+        const T& data = *it;
+        for (size_t i = 0; i < count; ++i) {
+            if (results[i] == last && data == values[i]) {
+                results[i] = it;
+                --pending;
+            }
+        }
+    }
+    return count - pending;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+
+// Benchmark body shared by the concurrent containers: every thread runs a mix of
+// Contains, Insert and Erase on one container over keys drawn uniformly from [0, keys).
+// range(0) is the percentage of Contains calls, the rest are split between Insert and Erase.
+// The container starts with every even key; insert(container, key) adds one
+template <typename Container, typename Insert>
+void RunMixedWorkload(benchmark::State& state, int keys, Insert insert) {
+    constexpr int Percent = 100;
+    static std::unique_ptr<Container> container;
+    if (state.thread_index() == 0) {
+        container = std::make_unique<Container>();
+        for (int key = 0; key < keys; key += 2) {
+            insert(*container, key);
+        }
+    }
+    std::mt19937 mt(state.thread_index() + 1);
+    std::uniform_int_distribution<int> key_distribution(0, keys - 1);
+    std::uniform_int_distribution<int> op_distribution(0, Percent - 1);
+    for (auto _ : state) {
+        int key = key_distribution(mt);
+        int op = op_distribution(mt);
+        if (op < state.range(0)) {
+            benchmark::DoNotOptimize(container->Contains(key));
+        } else if (op % 2 == 0) {
+            benchmark::DoNotOptimize(insert(*container, key));
+        } else {
+            benchmark::DoNotOptimize(container->Erase(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        container.reset();
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Process-wide map of the address regions that hold node chunks, one bit per region.
+// A node is told apart from an individually allocated one by its address alone, so
+// nodes carry no flag and can move between containers
+class ChunkRegions {
+private:
+    static constexpr size_t RegionBits = 16;
+    // User space addresses on x86-64 and AArch64
+    static constexpr size_t AddressBits = 48;
+    static constexpr size_t LeafBits = 16;
+    static constexpr size_t RootBits = AddressBits - RegionBits - LeafBits;
+    static constexpr size_t LeafRegions = size_t(1) << LeafBits;
+    static constexpr size_t WordBits = 64;
+
+public:
+    static constexpr size_t RegionBytes = size_t(1) << RegionBits;
+
+    static bool Contains(const void* address) noexcept {
+        size_t region = Region(address);
+        if (region >> (RootBits + LeafBits) != 0) {
+            return false;
+        }
+        Leaf* leaf = root_[region >> LeafBits].load(std::memory_order_acquire);
+        if (leaf == nullptr) {
+            return false;
+        }
+        size_t bit = region & (LeafRegions - 1);
+        return ((leaf->words_[bit / WordBits].load(std::memory_order_relaxed) >> (bit % WordBits)) & 1) != 0;
+    }
+
+    // Marks [begin, begin + bytes), both multiples of RegionBytes. Marks nothing if it throws
+    static void Add(const void* begin, size_t bytes) {
+        size_t first = Region(begin);
+        for (size_t region = first; region < first + bytes / RegionBytes; ++region) {
+            Leaf* leaf = nullptr;
+            try {
+                if (region >> (RootBits + LeafBits) != 0) {
+                    throw std::bad_alloc();
+                }
+                leaf = LeafFor(region);
+            } catch (...) {
+                Remove(begin, (region - first) * RegionBytes);
+                throw;
+            }
+            size_t bit = region & (LeafRegions - 1);
+            leaf->words_[bit / WordBits].fetch_or(uint64_t(1) << (bit % WordBits), std::memory_order_relaxed);
+        }
+    }
+
+    static void Remove(const void* begin, size_t bytes) noexcept {
+        for (size_t region = Region(begin); region < Region(begin) + bytes / RegionBytes; ++region) {
+            size_t bit = region & (LeafRegions - 1);
+            root_[region >> LeafBits]
+                .load(std::memory_order_acquire)
+                ->words_[bit / WordBits]
+                .fetch_and(~(uint64_t(1) << (bit % WordBits)), std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Leaf {
+        std::atomic<uint64_t> words_[LeafRegions / WordBits] = {};
+    };
+
+    // Leaves are created on first use and live as long as the process
+    inline static std::atomic<Leaf*> root_[size_t(1) << RootBits] = {};
+
+    static size_t Region(const void* address) noexcept {
+        return reinterpret_cast<std::uintptr_t>(address) >> RegionBits;
+    }
+
+    static Leaf* LeafFor(size_t region) {
+        std::atomic<Leaf*>& slot = root_[region >> LeafBits];
+        Leaf* leaf = slot.load(std::memory_order_acquire);
+        if (leaf != nullptr) {
+            return leaf;
+        }
+        auto* fresh = new Leaf();
+        if (slot.compare_exchange_strong(leaf, fresh, std::memory_order_acq_rel)) {
+            return fresh;
+        }
+        delete fresh;
+        return leaf;
+    }
+};
+
+// Chunks of nodes placed in traversal order by a list's Compact(). A chunk is aligned to
+// its size, so a node finds the header by masking its address, and the header counts the
+// live nodes: the chunk is freed with the last of them
+template <typename Node>
+class NodeChunks {
+private:
+    struct Chunk {
+        size_t live_;
+    };
+
+    static constexpr size_t MinChunkBytes = ChunkRegions::RegionBytes;
+    static constexpr size_t MinNodesPerChunk = 16;
+    static constexpr size_t HeaderBytes = (sizeof(Chunk) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+    static constexpr size_t ChunkBytes =
+        std::bit_ceil(std::max(MinChunkBytes, HeaderBytes + MinNodesPerChunk * sizeof(Node)));
+    static constexpr size_t NodesPerChunk = (ChunkBytes - HeaderBytes) / sizeof(Node);
+
+public:
+    // Hands out consecutive slots, holding a reference to the chunk being filled
+    class Filler {
+    public:
+        Filler() : chunk_(nullptr), next_slot_(NodesPerChunk) {
+        }
+
+        Filler(const Filler&) = delete;
+        Filler& operator=(const Filler&) = delete;
+
+        // A slot for one node. If constructing the node fails, give the slot back with Release
+        void* Acquire() {
+            if (next_slot_ == NodesPerChunk) {
+                Chunk* fresh = AllocateChunk();
+                if (chunk_ != nullptr) {
+                    ReleaseChunk(chunk_);
+                }
+                chunk_ = fresh;
+                next_slot_ = 0;
+            }
+            ++chunk_->live_;
+            return reinterpret_cast<char*>(chunk_) + HeaderBytes + next_slot_++ * sizeof(Node);
+        }
+
+        ~Filler() {
+            if (chunk_ != nullptr) {
+                ReleaseChunk(chunk_);
+            }
+        }
+
+    private:
+        Chunk* chunk_;
+        size_t next_slot_;
+    };
+
+    static bool Owns(const Node* node) noexcept {
+        return ChunkRegions::Contains(node);
+    }
+
+    // Frees the slot of a node that is already destroyed
+    static void Release(void* slot) noexcept {
+        ReleaseChunk(reinterpret_cast<Chunk*>(reinterpret_cast<std::uintptr_t>(slot) & ~(ChunkBytes - 1)));
+    }
+
+private:
+    // The returned chunk holds one reference for the filler
+    static Chunk* AllocateChunk() {
+        auto* chunk = static_cast<Chunk*>(::operator new(ChunkBytes, std::align_val_t(ChunkBytes)));
+        try {
+            ChunkRegions::Add(chunk, ChunkBytes);
+        } catch (...) {
+            ::operator delete(chunk, std::align_val_t(ChunkBytes));
+            throw;
+        }
+        chunk->live_ = 1;
+        return chunk;
+    }
+
+    static void ReleaseChunk(Chunk* chunk) noexcept {
+        if (--chunk->live_ == 0) {
+            ChunkRegions::Remove(chunk, ChunkBytes);
+            ::operator delete(chunk, std::align_val_t(ChunkBytes));
+        }
+    }
+};
@@ -1,14 +1,23 @@
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <functional>
 #include <iterator>
+#include <new>
+#include <span>
+#include <type_traits>
 #include <utility>
 
+#include "../../common/list_prefetch.hpp"
+#include "../../common/node_chunks.hpp"
 #include "exceptions.hpp"
 
-template <typename T>
+// TrackTail keeps a pointer to the last node: PushBack, Back and whole-list
+// SpliceAfter become O(1) at the cost of one pointer and a few tail updates
+template <typename T, bool TrackTail = false>
 class ForwardList {
 private:
     class Node {
@@ -19,9 +28,8 @@ private:
         T data_;
         Node* next_;
 
-        explicit Node(const T& value, Node* next_node = nullptr) {
-            data_ = value;
-            next_ = next_node;
+        template <typename... Args>
+        explicit Node(Node* next_node, Args&&... args) : data_(std::forward<Args>(args)...), next_(next_node) {
         }
     };
 
@@ -41,6 +49,10 @@ public:
         // NOLINTNEXTLINE
         using reference = T&;
 
+        ForwardListIterator() {
+            current_ = nullptr;
+        }
+
         explicit ForwardListIterator(Node* node) {
             current_ = node;
         }
@@ -70,6 +82,11 @@ public:
             return current_ != other.current_;
         }
 
+    protected:
+        const void* NextNode() const noexcept {
+            return current_ ? current_->next_ : nullptr;
+        }
+
     private:
         Node* current_;
     };
@@ -78,42 +95,28 @@ public:
     ForwardList() {
         head_ = nullptr;
         size_ = 0;
+        tail_ = TailPointer();
     }
 
-    explicit ForwardList(size_t sz) {
-        head_ = nullptr;
-        size_ = 0;
+    explicit ForwardList(size_t sz) : ForwardList() {
+        Node* last = nullptr;
         for (size_t i = 0; i < sz; ++i) {
-            PushFront(T());
+            last = LinkAfterLast(last, new Node(nullptr));
         }
     }
 
-    ForwardList(const std::initializer_list<T>& values) {
-        head_ = nullptr;
-        size_ = 0;
-        for (auto it = std::rbegin(values); it != std::rend(values); ++it) {
-            PushFront(*it);
+    ForwardList(const std::initializer_list<T>& values) : ForwardList() {
+        Node* last = nullptr;
+        for (const auto& value : values) {
+            last = LinkAfterLast(last, new Node(nullptr, value));
         }
     }
 
-    ForwardList(const ForwardList& other) {
-        head_ = nullptr;
-        size_ = 0;
-        Node* cur = other.head_;
-        Node* prev = nullptr;
-
-        while (cur) {
-            Node* new_node = new Node(cur->data_);
-            if (!head_) {
-                head_ = new_node;
-            }
-            if (prev) {
-                prev->next_ = new_node;
-            }
-            prev = new_node;
-            cur = cur->next_;
+    ForwardList(const ForwardList& other) : ForwardList() {
+        Node* last = nullptr;
+        for (Node* cur = other.head_; cur; cur = cur->next_) {
+            last = LinkAfterLast(last, new Node(nullptr, cur->data_));
         }
-        size_ = other.size_;
     }
 
     ForwardList& operator=(const ForwardList& other) {
@@ -121,21 +124,23 @@ public:
             return *this;
         }
         Clear();
-        Node* cur = other.head_;
-        Node* prev = nullptr;
+        Node* last = nullptr;
+        for (Node* cur = other.head_; cur; cur = cur->next_) {
+            last = LinkAfterLast(last, new Node(nullptr, cur->data_));
+        }
+        return *this;
+    }
 
-        while (cur) {
-            Node* new_node = new Node(cur->data_);
-            if (!head_) {
-                head_ = new_node;
-            }
-            if (prev) {
-                prev->next_ = new_node;
-            }
-            prev = new_node;
-            cur = cur->next_;
+    ForwardList(ForwardList&& other) noexcept : ForwardList() {
+        Swap(other);
+    }
+
+    ForwardList& operator=(ForwardList&& other) noexcept {
+        if (this == &other) {
+            return *this;
         }
-        size_ = other.size_;
+        Clear();
+        Swap(other);
         return *this;
     }
 
@@ -146,10 +151,30 @@ public:
         return ForwardListIterator(nullptr);
     }
 
+    PrefetchIterator<ForwardListIterator> PrefetchBegin() const noexcept {
+        return PrefetchIterator<ForwardListIterator>(Begin());
+    }
+
+    // Iterator to the last element, InsertAfter(BeforeEnd(), value) appends in O(1)
+    ForwardListIterator BeforeEnd() const noexcept
+        requires TrackTail
+    {
+        return ForwardListIterator(tail_);
+    }
+
     inline T& Front() const {
         return head_->data_;
     }
 
+    inline T& Back() const
+        requires TrackTail
+    {
+        if (!tail_) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return tail_->data_;
+    }
+
     inline bool IsEmpty() const noexcept {
         return head_ == nullptr;
     }
@@ -158,9 +183,10 @@ public:
         return size_;
     }
 
-    void Swap(ForwardList& other) {
+    void Swap(ForwardList& other) noexcept {
         std::swap(head_, other.head_);
         std::swap(size_, other.size_);
+        std::swap(tail_, other.tail_);
     }
 
     void EraseAfter(ForwardListIterator pos) {
@@ -172,17 +198,37 @@ public:
         }
         Node* temp = pos.current_->next_;
         pos.current_->next_ = temp->next_;
-        delete temp;
+        if constexpr (TrackTail) {
+            if (temp == tail_) {
+                tail_ = pos.current_;
+            }
+        }
+        DestroyNode(temp);
         --size_;
     }
 
     void InsertAfter(ForwardListIterator pos, const T& value) {
+        EmplaceAfter(pos, value);
+    }
+
+    void InsertAfter(ForwardListIterator pos, T&& value) {
+        EmplaceAfter(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    ForwardListIterator EmplaceAfter(ForwardListIterator pos, Args&&... args) {
         if (!pos.current_) {
-            return;
+            return End();
         }
-        Node* new_node = new Node(value, pos.current_->next_);
+        Node* new_node = new Node(pos.current_->next_, std::forward<Args>(args)...);
         pos.current_->next_ = new_node;
+        if constexpr (TrackTail) {
+            if (pos.current_ == tail_) {
+                tail_ = new_node;
+            }
+        }
         ++size_;
+        return ForwardListIterator(new_node);
     }
 
     ForwardListIterator Find(const T& value) const {
@@ -196,15 +242,58 @@ public:
         return End();
     }
 
+    // Looks up all values in a single walk, see FindManyInRange
+    size_t FindMany(std::span<const T> values, std::span<ForwardListIterator> results) const {
+        return FindManyInRange(Begin(), End(), values, results);
+    }
+
     void Clear() noexcept {
         while (head_) {
-            PopFront();
+            Node* next = head_->next_;
+            DestroyNode(head_);
+            head_ = next;
         }
+        size_ = 0;
+        tail_ = TailPointer();
     }
 
     void PushFront(const T& value) {
-        head_ = new Node(value, head_);
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        head_ = new Node(head_, std::forward<Args>(args)...);
+        if constexpr (TrackTail) {
+            if (!head_->next_) {
+                tail_ = head_;
+            }
+        }
         ++size_;
+        return head_->data_;
+    }
+
+    void PushBack(const T& value)
+        requires TrackTail
+    {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value)
+        requires TrackTail
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args)
+        requires TrackTail
+    {
+        return LinkAfterLast(tail_, new Node(nullptr, std::forward<Args>(args)...))->data_;
     }
 
     void PopFront() {
@@ -214,23 +303,361 @@ public:
         // Node -> begin
         Node* temp = head_;
         head_ = head_->next_;
-        delete temp;
+        if constexpr (TrackTail) {
+            if (!head_) {
+                tail_ = nullptr;
+            }
+        }
+        DestroyNode(temp);
         --size_;
     }
 
+    // Moves all elements of other after pos, O(1) with TrackTail
+    void SpliceAfter(ForwardListIterator pos, ForwardList& other) noexcept {
+        if (!pos.current_ || this == &other || other.IsEmpty()) {
+            return;
+        }
+        Node* last = other.LastNode();
+        last->next_ = pos.current_->next_;
+        pos.current_->next_ = other.head_;
+        if constexpr (TrackTail) {
+            if (pos.current_ == tail_) {
+                tail_ = last;
+            }
+        }
+        size_ += other.size_;
+        other.head_ = nullptr;
+        other.size_ = 0;
+        other.tail_ = TailPointer();
+    }
+
+    // Appends all elements of other, also works when this list is empty
+    void SpliceBack(ForwardList& other) noexcept
+        requires TrackTail
+    {
+        if (this == &other || other.IsEmpty()) {
+            return;
+        }
+        (tail_ ? tail_->next_ : head_) = other.head_;
+        tail_ = other.tail_;
+        size_ += other.size_;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Moves the element following it from other after pos
+    void SpliceAfter(ForwardListIterator pos, ForwardList& other, ForwardListIterator it) noexcept {
+        if (!pos.current_ || !it.current_ || !it.current_->next_ || pos == it || pos.current_ == it.current_->next_) {
+            return;
+        }
+        Node* node = it.current_->next_;
+        it.current_->next_ = node->next_;
+        if constexpr (TrackTail) {
+            if (node == other.tail_) {
+                other.tail_ = it.current_;
+            }
+        }
+        node->next_ = pos.current_->next_;
+        pos.current_->next_ = node;
+        if constexpr (TrackTail) {
+            if (pos.current_ == tail_) {
+                tail_ = node;
+            }
+        }
+        --other.size_;
+        ++size_;
+    }
+
+    // Moves (before_first, last) from other after pos. The node preceding
+    // last has to be found by walking the range, so this is O(range)
+    void SpliceAfter(ForwardListIterator pos, ForwardList& other, ForwardListIterator before_first,
+                     ForwardListIterator last) noexcept {
+        if (!pos.current_ || !before_first.current_ || before_first.current_->next_ == last.current_) {
+            return;
+        }
+        Node* first = before_first.current_->next_;
+        Node* last_node = first;
+        size_t count = 1;
+        while (last_node->next_ != last.current_) {
+            last_node = last_node->next_;
+            ++count;
+        }
+        before_first.current_->next_ = last.current_;
+        if constexpr (TrackTail) {
+            if (last_node == other.tail_) {
+                other.tail_ = before_first.current_;
+            }
+        }
+        last_node->next_ = pos.current_->next_;
+        pos.current_->next_ = first;
+        if constexpr (TrackTail) {
+            if (pos.current_ == tail_) {
+                tail_ = last_node;
+            }
+        }
+        other.size_ -= count;
+        size_ += count;
+    }
+
+    // Merges sorted other into this sorted list, other becomes empty. If comp
+    // throws, all elements of both lists stay in this one in unspecified order
+    template <typename Compare = std::less<T>>
+    void Merge(ForwardList& other, Compare comp = Compare()) {
+        if (this == &other || other.IsEmpty()) {
+            return;
+        }
+        Node* a = head_;
+        Node* b = other.head_;
+        size_ += other.size_;
+        other.head_ = nullptr;
+        other.size_ = 0;
+        if constexpr (TrackTail) {
+            other.tail_ = nullptr;
+        }
+        try {
+            head_ = MergeChains(a, b, comp);
+        } catch (...) {
+            head_ = a;
+            if constexpr (TrackTail) {
+                tail_ = FindLastNode();
+            }
+            throw;
+        }
+        if constexpr (TrackTail) {
+            tail_ = FindLastNode();
+        }
+    }
+
+    // Stable bottom-up merge sort, relinks nodes without allocations. If comp
+    // throws, the elements are kept in unspecified order
+    template <typename Compare = std::less<T>>
+    void Sort(Compare comp = Compare()) {
+        if (size_ < 2) {
+            return;
+        }
+        try {
+            head_ = SortChain(head_, comp);
+        } catch (...) {
+            if constexpr (TrackTail) {
+                tail_ = FindLastNode();
+            }
+            throw;
+        }
+        if constexpr (TrackTail) {
+            tail_ = FindLastNode();
+        }
+    }
+
+    void Reverse() noexcept {
+        if constexpr (TrackTail) {
+            tail_ = head_;
+        }
+        Node* prev = nullptr;
+        while (head_) {
+            Node* next = head_->next_;
+            head_->next_ = prev;
+            prev = head_;
+            head_ = next;
+        }
+        head_ = prev;
+    }
+
+    // Removes consecutive duplicates, returns the number of removed elements
+    size_t Unique() {
+        return UniqueIf(std::equal_to<T>());
+    }
+
+    template <typename BinaryPredicate>
+    size_t UniqueIf(BinaryPredicate pred) {
+        size_t removed = 0;
+        for (Node* cur = head_; cur && cur->next_;) {
+            if (pred(cur->data_, cur->next_->data_)) {
+                EraseAfter(ForwardListIterator(cur));
+                ++removed;
+            } else {
+                cur = cur->next_;
+            }
+        }
+        return removed;
+    }
+
+    template <typename Predicate>
+    size_t RemoveIf(Predicate pred) {
+        size_t removed = 0;
+        Node** link = &head_;
+        Node* last_kept = nullptr;
+        while (*link) {
+            Node* cur = *link;
+            if (pred(cur->data_)) {
+                *link = cur->next_;
+                DestroyNode(cur);
+                --size_;
+                ++removed;
+            } else {
+                last_kept = cur;
+                link = &cur->next_;
+            }
+        }
+        if constexpr (TrackTail) {
+            tail_ = last_kept;
+        }
+        return removed;
+    }
+
+    // Moves the elements into freshly allocated chunks in traversal order and
+    // frees the old nodes, so iteration walks memory sequentially.
+    // Invalidates all iterators, pointers and references to elements
+    void Compact() {
+        ForwardList compacted;
+        Node* last = nullptr;
+        typename Chunks::Filler filler;
+        for (Node* cur = head_; cur; cur = cur->next_) {
+            void* slot = filler.Acquire();
+            Node* node;
+            try {
+                node = new (slot) Node(nullptr, std::move_if_noexcept(cur->data_));
+            } catch (...) {
+                Chunks::Release(slot);
+                throw;
+            }
+            last = compacted.LinkAfterLast(last, node);
+        }
+        Swap(compacted);
+    }
+
     ~ForwardList() {
         Clear();
     }
 
 private:
+    struct NoTail {};
+    using TailPointer = std::conditional_t<TrackTail, Node*, NoTail>;
+
     Node* head_;
     size_t size_;
+    [[no_unique_address]] TailPointer tail_;
+
+    using Chunks = NodeChunks<Node>;
+
+    static constexpr size_t SortBuckets = 64;
+
+    // Links node after last (as head if last is nullptr), returns the new last node
+    Node* LinkAfterLast(Node* last, Node* node) noexcept {
+        (last ? last->next_ : head_) = node;
+        if constexpr (TrackTail) {
+            tail_ = node;
+        }
+        ++size_;
+        return node;
+    }
+
+    Node* LastNode() const noexcept {
+        if constexpr (TrackTail) {
+            return tail_;
+        } else {
+            return FindLastNode();
+        }
+    }
+
+    Node* FindLastNode() const noexcept {
+        Node* last = head_;
+        while (last && last->next_) {
+            last = last->next_;
+        }
+        return last;
+    }
+
+    static void DestroyNode(Node* node) noexcept {
+        if (!Chunks::Owns(node)) {
+            delete node;
+            return;
+        }
+        node->~Node();
+        Chunks::Release(node);
+    }
+
+    // Appends chain b to chain a
+    static Node* Concat(Node* a, Node* b) noexcept {
+        if (!a) {
+            return b;
+        }
+        Node* tail = a;
+        while (tail->next_) {
+            tail = tail->next_;
+        }
+        tail->next_ = b;
+        return a;
+    }
+
+    // Merges two nullptr-terminated sorted chains, ties keep a first. Both chains
+    // are consumed. If comp throws, a holds every node of both and b is empty
+    template <typename Compare>
+    static Node* MergeChains(Node*& a, Node*& b, Compare& comp) {
+        Node* head = nullptr;
+        Node** link = &head;
+        try {
+            while (a && b) {
+                if (comp(b->data_, a->data_)) {
+                    *link = b;
+                    b = b->next_;
+                } else {
+                    *link = a;
+                    a = a->next_;
+                }
+                link = &(*link)->next_;
+            }
+        } catch (...) {
+            *link = Concat(a, b);
+            a = head;
+            b = nullptr;
+            throw;
+        }
+        *link = a ? a : b;
+        a = b = nullptr;
+        return head;
+    }
+
+    // buckets[i] holds a sorted run of 2^i nodes, so no extra memory is needed.
+    // If comp throws, head holds every node again
+    template <typename Compare>
+    static Node* SortChain(Node*& head, Compare& comp) {
+        Node* buckets[SortBuckets] = {};
+        size_t used = 0;
+        Node* carry = nullptr;
+        Node* result = nullptr;
+        try {
+            while (head) {
+                carry = head;
+                head = head->next_;
+                carry->next_ = nullptr;
+                size_t i = 0;
+                for (; i < used && buckets[i]; ++i) {
+                    carry = MergeChains(buckets[i], carry, comp);
+                }
+                if (i == used) {
+                    ++used;
+                }
+                buckets[i] = carry;
+                carry = nullptr;
+            }
+            for (size_t i = 0; i < used; ++i) {
+                result = MergeChains(buckets[i], result, comp);
+            }
+        } catch (...) {
+            head = Concat(Concat(carry, result), head);
+            for (size_t i = 0; i < used; ++i) {
+                head = Concat(buckets[i], head);
+            }
+            throw;
+        }
+        return result;
+    }
 };
 
 namespace std {
-template <typename T>
+template <typename T, bool TrackTail>
 // NOLINTNEXTLINE
-void swap(ForwardList<T>& a, ForwardList<T>& b) {
+void swap(ForwardList<T, TrackTail>& a, ForwardList<T, TrackTail>& b) {
     a.Swap(b);
 }
 }  // namespace std
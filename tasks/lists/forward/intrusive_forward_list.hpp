@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// Base of objects that can be linked into an IntrusiveForwardList<T, Tag>; an object
+// derives from one hook per list it can be in at the same time, told apart by Tag.
+// A singly linked hook cannot unlink itself, so objects must be erased
+// from their list before they are destroyed
+template <typename Tag = void>
+class IntrusiveForwardListHook {
+    template <typename T, typename ListTag>
+    friend class IntrusiveForwardList;
+
+public:
+    IntrusiveForwardListHook() : next_(nullptr) {
+    }
+
+    // Copying an object does not copy its list membership
+    IntrusiveForwardListHook(const IntrusiveForwardListHook&) : IntrusiveForwardListHook() {
+    }
+
+    IntrusiveForwardListHook& operator=(const IntrusiveForwardListHook&) {
+        return *this;
+    }
+
+private:
+    IntrusiveForwardListHook* next_;
+};
+
+// Singly linked list over objects derived from IntrusiveForwardListHook<Tag>:
+// linking only wires the hook, the list never allocates, copies or destroys elements
+template <typename T, typename Tag = void>
+class IntrusiveForwardList {
+    using Hook = IntrusiveForwardListHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from IntrusiveForwardListHook<Tag>");
+
+public:
+    class IntrusiveForwardListIterator {
+        friend class IntrusiveForwardList;
+
+    public:
+        // NOLINTNEXTLINE
+        using iterator_category = std::forward_iterator_tag;
+        // NOLINTNEXTLINE
+        using value_type = T;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using pointer = T*;
+        // NOLINTNEXTLINE
+        using reference = T&;
+
+        IntrusiveForwardListIterator() {
+            current_ = nullptr;
+        }
+
+        T& operator*() const {
+            return *FromHook(current_);
+        }
+
+        T* operator->() const {
+            return FromHook(current_);
+        }
+
+        IntrusiveForwardListIterator& operator++() {
+            if (current_) {
+                current_ = current_->next_;
+            }
+            return *this;
+        }
+
+        IntrusiveForwardListIterator operator++(int) {
+            IntrusiveForwardListIterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const IntrusiveForwardListIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        bool operator!=(const IntrusiveForwardListIterator& other) const {
+            return current_ != other.current_;
+        }
+
+    private:
+        Hook* current_;
+
+        explicit IntrusiveForwardListIterator(Hook* hook) {
+            current_ = hook;
+        }
+    };
+
+    IntrusiveForwardList() {
+        size_ = 0;
+    }
+
+    IntrusiveForwardList(const IntrusiveForwardList&) = delete;
+    IntrusiveForwardList& operator=(const IntrusiveForwardList&) = delete;
+
+    IntrusiveForwardList(IntrusiveForwardList&& other) noexcept : IntrusiveForwardList() {
+        Swap(other);
+    }
+
+    IntrusiveForwardList& operator=(IntrusiveForwardList&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    // Position before the first element, only valid for InsertAfter/EraseAfter
+    IntrusiveForwardListIterator BeforeBegin() const noexcept {
+        return IntrusiveForwardListIterator(&head_);
+    }
+
+    IntrusiveForwardListIterator Begin() const noexcept {
+        return IntrusiveForwardListIterator(head_.next_);
+    }
+
+    IntrusiveForwardListIterator End() const noexcept {
+        return IntrusiveForwardListIterator(nullptr);
+    }
+
+    inline T& Front() const {
+        if (!head_.next_) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return *FromHook(head_.next_);
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return head_.next_ == nullptr;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    void Swap(IntrusiveForwardList& other) noexcept {
+        std::swap(head_.next_, other.head_.next_);
+        std::swap(size_, other.size_);
+    }
+
+    // The element must not be linked into another list
+    void PushFront(T& value) noexcept {
+        InsertAfter(BeforeBegin(), value);
+    }
+
+    void PopFront() {
+        if (!head_.next_) {
+            throw ListIsEmptyException("List is empty");
+        }
+        EraseAfter(BeforeBegin());
+    }
+
+    IntrusiveForwardListIterator InsertAfter(IntrusiveForwardListIterator pos, T& value) noexcept {
+        if (!pos.current_) {
+            return End();
+        }
+        Hook* hook = &value;
+        hook->next_ = pos.current_->next_;
+        pos.current_->next_ = hook;
+        ++size_;
+        return IntrusiveForwardListIterator(hook);
+    }
+
+    // Unlinks the element following pos, the object itself stays alive
+    void EraseAfter(IntrusiveForwardListIterator pos) noexcept {
+        if (!pos.current_ || !pos.current_->next_) {
+            return;
+        }
+        Hook* hook = pos.current_->next_;
+        pos.current_->next_ = hook->next_;
+        hook->next_ = nullptr;
+        --size_;
+    }
+
+    IntrusiveForwardListIterator Find(const T& value) const {
+        for (Hook* cur = head_.next_; cur; cur = cur->next_) {
+            if (*FromHook(cur) == value) {
+                return IntrusiveForwardListIterator(cur);
+            }
+        }
+        return End();
+    }
+
+    void Clear() noexcept {
+        while (head_.next_) {
+            EraseAfter(BeforeBegin());
+        }
+    }
+
+    ~IntrusiveForwardList() {
+        Clear();
+    }
+
+private:
+    mutable Hook head_;
+    size_t size_;
+
+    static T* FromHook(Hook* hook) noexcept {
+        return static_cast<T*>(hook);
+    }
+};
+
+namespace std {
+template <typename T, typename Tag>
+// NOLINTNEXTLINE
+void swap(IntrusiveForwardList<T, Tag>& a, IntrusiveForwardList<T, Tag>& b) {
+    a.Swap(b);
+}
+}  // namespace std
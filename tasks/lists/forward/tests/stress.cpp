@@ -1,11 +1,13 @@
 #include <random>
 #include <forward_list>
 #include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
 
 #include "../forward_list.hpp"
+#include "../intrusive_forward_list.hpp"
 
 void ConstructRandomList(ForwardList<int>& list, int sz) {
   std::random_device rd;
@@ -143,6 +145,314 @@ void BM_StdListFind(benchmark::State& state) {
 }
 
 
+const size_t PayloadLength = 64;
+
+void BM_CustomListPushFrontStringCopy(benchmark::State& state) {
+  for (auto _ : state) {
+    ForwardList<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      std::string payload(PayloadLength, 'a' + i % 26);
+      list.PushFront(payload);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListPushFrontStringMove(benchmark::State& state) {
+  for (auto _ : state) {
+    ForwardList<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      std::string payload(PayloadLength, 'a' + i % 26);
+      list.PushFront(std::move(payload));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListEmplaceFrontString(benchmark::State& state) {
+  for (auto _ : state) {
+    ForwardList<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.EmplaceFront(PayloadLength, 'a' + i % 26);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListEmplaceFrontString(benchmark::State& state) {
+  for (auto _ : state) {
+    std::forward_list<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.emplace_front(PayloadLength, 'a' + i % 26);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+void BM_CustomListSort(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    ForwardList<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    list.Sort();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListCopySortRebuild(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    ForwardList<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    std::vector<int> values(list.Begin(), list.End());
+    std::sort(values.begin(), values.end());
+    list.Clear();
+    for (auto it = values.rbegin(); it != values.rend(); ++it) {
+      list.PushFront(*it);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListSort(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::forward_list<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    list.sort();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Sorting random values relinks the nodes, so traversal order becomes random in memory
+void ConstructFragmentedList(ForwardList<int>& list, int sz) {
+  ConstructRandomList(list, sz);
+  list.Sort();
+}
+
+int64_t TraverseList(const ForwardList<int>& list) {
+  int64_t sum = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    sum += *it;
+  }
+  return sum;
+}
+
+void BM_CustomListTraverseFragmented(benchmark::State& state) {
+  ForwardList<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TraverseList(list));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraverseCompacted(benchmark::State& state) {
+  ForwardList<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  list.Compact();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TraverseList(list));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListCompact(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    ForwardList<int> list;
+    ConstructFragmentedList(list, state.range(0));
+    state.ResumeTiming();
+    list.Compact();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Fills a queue of range(0) elements, then keeps it full for range(0) push/pop pairs
+void BM_CustomListFifo(benchmark::State& state) {
+  for (auto _ : state) {
+    ForwardList<int, true> queue;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      queue.PushBack(i);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      queue.PushBack(i);
+      queue.PopFront();
+    }
+    queue.Clear();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListFifo(benchmark::State& state) {
+  for (auto _ : state) {
+    std::forward_list<int> queue;
+    auto tail = queue.before_begin();
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      tail = queue.insert_after(tail, i);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      tail = queue.insert_after(tail, i);
+      queue.pop_front();
+    }
+    queue.clear();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Half of the queries hit elements spread over the whole list, the rest most likely miss
+std::vector<int> RandomQueries(const ForwardList<int>& list, int64_t count) {
+  std::mt19937 mt(count);
+  std::vector<int> queries;
+  int64_t step = static_cast<int64_t>(list.Size()) / count * 2;
+  int64_t pos = 0;
+  for (auto it = list.Begin(); it != list.End() && static_cast<int64_t>(queries.size()) < count / 2; ++it, ++pos) {
+    if (pos % step == step - 1) {
+      queries.push_back(*it);
+    }
+  }
+  while (static_cast<int64_t>(queries.size()) < count) {
+    queries.push_back(static_cast<int>(mt()));
+  }
+  return queries;
+}
+
+void BM_CustomListFindEach(benchmark::State& state) {
+  ForwardList<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  std::vector<int> queries = RandomQueries(list, state.range(1));
+  for (auto _ : state) {
+    for (int query : queries) {
+      benchmark::DoNotOptimize(list.Find(query));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListFindMany(benchmark::State& state) {
+  ForwardList<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  std::vector<int> queries = RandomQueries(list, state.range(1));
+  std::vector<ForwardList<int>::ForwardListIterator> results(queries.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(list.FindMany(queries, results));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraversePrefetch(benchmark::State& state) {
+  ForwardList<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = list.PrefetchBegin(); it != list.End(); ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+struct PooledItem : IntrusiveForwardListHook<> {
+  int value;
+
+  explicit PooledItem(int v) : value(v) {
+  }
+
+  bool operator==(const PooledItem& other) const {
+    return value == other.value;
+  }
+};
+
+using PooledItemList = IntrusiveForwardList<PooledItem>;
+
+std::vector<PooledItem> ConstructItems(int64_t size) {
+  std::vector<PooledItem> items;
+  items.reserve(size);
+  for (int64_t i = 0; i < size; ++i) {
+    items.emplace_back(static_cast<int>(i));
+  }
+  return items;
+}
+
+void BM_IntrusiveForwardListLinkTraverse(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    PooledItemList list;
+    for (auto& item : items) {
+      list.PushFront(item);
+    }
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += it->value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomForwardListPointerLinkTraverse(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    ForwardList<PooledItem*> list;
+    for (auto& item : items) {
+      list.PushFront(&item);
+    }
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += (*it)->value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Unlinks every other element in a single pass
+void BM_IntrusiveForwardListErase(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    PooledItemList list;
+    for (auto& item : items) {
+      list.PushFront(item);
+    }
+    state.ResumeTiming();
+    for (auto it = list.BeforeBegin(); it != list.End(); ++it) {
+      list.EraseAfter(it);
+    }
+    benchmark::DoNotOptimize(list.Begin());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomForwardListPointerErase(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    ForwardList<PooledItem*> list;
+    for (auto& item : items) {
+      list.PushFront(&item);
+    }
+    state.ResumeTiming();
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      list.EraseAfter(it);
+    }
+    benchmark::DoNotOptimize(list.Begin());
+    state.PauseTiming();
+    list.Clear();
+    state.ResumeTiming();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 BENCHMARK(BM_CustomListPushFront)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListPushFront)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
@@ -154,5 +464,29 @@ BENCHMARK(BM_StdListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::k
 BENCHMARK(BM_CustomListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_CustomListPushFrontStringCopy)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListPushFrontStringMove)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListEmplaceFrontString)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListEmplaceFrontString)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListSort)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListCopySortRebuild)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListSort)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListTraverseFragmented)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraverseCompacted)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListCompact)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListFifo)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListFifo)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListFindEach)->Ranges({{1<<12, 1<<21}, {4, 16}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListFindMany)->Ranges({{1<<12, 1<<21}, {4, 16}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraversePrefetch)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_IntrusiveForwardListLinkTraverse)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomForwardListPointerLinkTraverse)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IntrusiveForwardListErase)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomForwardListPointerErase)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
\ No newline at end of file
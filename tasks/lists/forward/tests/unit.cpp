@@ -1,10 +1,16 @@
 #include <forward_list>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <span>
+#include <string>
 #include <thread>
 #include <future>
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
 #include "../forward_list.hpp"
+#include "../intrusive_forward_list.hpp"
 
 class ListTest: public testing::Test {
   protected:
@@ -205,6 +211,377 @@ TEST_F(ListTest, Clear) {
   ASSERT_EQ(list.Size(), 0);
 }
 
+TEST(EmptyListTest, PushFrontMoveOnly) {
+  ForwardList<std::unique_ptr<int>> list;
+  list.PushFront(std::make_unique<int>(2));
+  list.PushFront(std::make_unique<int>(1));
+  ASSERT_EQ(list.Size(), 2);
+  ASSERT_EQ(*list.Front(), 1);
+}
+
+TEST(EmptyListTest, EmplaceInPlace) {
+  ForwardList<std::string> list;
+  ASSERT_EQ(list.EmplaceFront(2, 'a'), "aa");
+  auto it = list.EmplaceAfter(list.Begin(), 3, 'c');
+  ASSERT_EQ(*it, "ccc");
+  it = list.EmplaceAfter(list.Begin(), "b");
+  ASSERT_EQ(*it, "b");
+  ASSERT_EQ(list.EmplaceAfter(list.End(), "x"), list.End());
+  ASSERT_EQ(list.Size(), 3);
+  std::string expected[] = {"aa", "b", "ccc"};
+  size_t i = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected[i++]);
+  }
+}
+
+TEST_F(ListTest, MoveConstructor) {
+  ForwardList<int> lst = std::move(list);
+  ASSERT_EQ(lst.Size(), sz);
+  ASSERT_TRUE(list.IsEmpty());
+  int iter = 7;
+  for (auto it = lst.Begin(); it != lst.End(); ++it) {
+    ASSERT_EQ(*it, iter--);
+  }
+}
+
+TEST_F(ListTest, MoveAssigment) {
+  ForwardList<int> lst{10, 20};
+  lst = std::move(list);
+  ASSERT_EQ(lst.Size(), sz);
+  ASSERT_EQ(lst.Front(), 7);
+  ASSERT_TRUE(list.IsEmpty());
+  list.PushFront(1);
+  ASSERT_EQ(list.Front(), 1);
+}
+
+template <typename T, bool TrackTail = false>
+void ExpectListEq(const ForwardList<T, TrackTail>& list, std::initializer_list<T> expected) {
+  ASSERT_EQ(list.Size(), expected.size());
+  auto it = list.Begin();
+  for (const auto& value : expected) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  ASSERT_EQ(it, list.End());
+}
+
+TEST(EmptyListTest, SortStable) {
+  ForwardList<std::pair<int, int>> list{{3, 0}, {1, 1}, {2, 2}, {1, 3}, {3, 4}, {0, 5}};
+  list.Sort([](const auto& a, const auto& b) { return a.first < b.first; });
+  ExpectListEq<std::pair<int, int>>(list, {{0, 5}, {1, 1}, {1, 3}, {2, 2}, {3, 0}, {3, 4}});
+}
+
+TEST(EmptyListTest, SortLarge) {
+  ForwardList<int> list;
+  for (int i = 0; i < 1000; ++i) {
+    list.PushFront((i * 7919) % 1000);
+  }
+  list.Sort(std::greater<int>());
+  int expected = 999;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected--);
+  }
+}
+
+TEST(EmptyListTest, Merge) {
+  ForwardList<int> list{1, 4, 6};
+  ForwardList<int> other{2, 3, 5, 7};
+  list.Merge(other);
+  ASSERT_TRUE(other.IsEmpty());
+  ExpectListEq(list, {1, 2, 3, 4, 5, 6, 7});
+}
+
+TEST(EmptyListTest, ThrowingComparatorKeepsElements) {
+  for (int throw_after : {0, 5, 50, 300}) {
+    ForwardList<int, true> list;
+    ForwardList<int, true> other;
+    for (int i = 0; i < 200; ++i) {
+      list.PushFront((i * 7919) % 200);
+      other.PushFront(199 - i);
+    }
+    int calls = 0;
+    auto comp = [&calls, throw_after](int a, int b) {
+      if (calls++ == throw_after) {
+        throw std::runtime_error("comparator");
+      }
+      return a < b;
+    };
+    ASSERT_THROW(list.Sort(comp), std::runtime_error);
+    ASSERT_EQ(list.Size(), 200);
+    ASSERT_EQ(std::accumulate(list.Begin(), list.End(), 0), 199 * 100);
+    calls = 0;
+    list.Sort();
+    ASSERT_THROW(list.Merge(other, comp), std::runtime_error);
+    ASSERT_TRUE(other.IsEmpty());
+    ASSERT_EQ(list.Size(), 400);
+    ASSERT_EQ(std::accumulate(list.Begin(), list.End(), 0), 2 * 199 * 100);
+    list.PushBack(-1);
+    ASSERT_EQ(list.Back(), -1);
+  }
+}
+
+TEST_F(ListTest, SpliceAfter) {
+  ForwardList<int> other{10, 11, 12, 13};
+  list.SpliceAfter(list.Begin(), other, other.Begin());
+  ExpectListEq(list, {7, 11, 6, 5, 4, 3, 2, 1});
+  ExpectListEq(other, {10, 12, 13});
+
+  list.SpliceAfter(list.Begin(), other, other.Begin(), other.End());
+  ExpectListEq(list, {7, 12, 13, 11, 6, 5, 4, 3, 2, 1});
+  ExpectListEq(other, {10});
+
+  list.SpliceAfter(list.Find(1), other);
+  ASSERT_TRUE(other.IsEmpty());
+  ExpectListEq(list, {7, 12, 13, 11, 6, 5, 4, 3, 2, 1, 10});
+}
+
+TEST_F(ListTest, Reverse) {
+  list.Reverse();
+  ExpectListEq(list, {1, 2, 3, 4, 5, 6, 7});
+}
+
+TEST(EmptyListTest, UniqueAndRemoveIf) {
+  ForwardList<int> list{1, 1, 2, 2, 2, 3, 1, 1};
+  ASSERT_EQ(list.Unique(), 4);
+  ExpectListEq(list, {1, 2, 3, 1});
+  ASSERT_EQ(list.RemoveIf([](int x) { return x == 1; }), 2);
+  ExpectListEq(list, {2, 3});
+}
+
+TEST_F(ListTest, CompactKeepsOrder) {
+  list.Sort();
+  list.Compact();
+  ExpectListEq(list, {1, 2, 3, 4, 5, 6, 7});
+  list.EraseAfter(list.Begin());
+  list.PopFront();
+  list.PushFront(0);
+  list.Compact();
+  ExpectListEq(list, {0, 3, 4, 5, 6, 7});
+}
+
+TEST(EmptyListTest, CompactLargeAndSplice) {
+  ForwardList<std::string> list;
+  for (int i = 0; i < 10000; ++i) {
+    list.PushFront(std::to_string(i));
+  }
+  list.Compact();
+  ASSERT_EQ(list.Size(), 10000);
+  int expected = 9999;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, std::to_string(expected--));
+  }
+
+  ForwardList<std::string> other{"x"};
+  other.SpliceAfter(other.Begin(), list, list.Begin(), list.End());
+  ASSERT_EQ(other.Size(), 10000);
+  ASSERT_EQ(list.Size(), 1);
+  list.Clear();
+  other.PopFront();
+  ASSERT_EQ(other.Front(), "9998");
+}
+
+using TailList = ForwardList<int, true>;
+
+// Back() has to match the last element reached by iteration
+void ExpectTailList(TailList& list, std::initializer_list<int> expected) {
+  ExpectListEq(list, expected);
+  if (list.IsEmpty()) {
+    ASSERT_EQ(list.BeforeEnd(), list.End());
+    return;
+  }
+  ASSERT_EQ(list.Back(), *std::rbegin(expected));
+  auto last = list.Begin();
+  std::advance(last, list.Size() - 1);
+  ASSERT_EQ(list.BeforeEnd(), last);
+}
+
+TEST(TailListTest, PushBackFifo) {
+  TailList list;
+  EXPECT_THROW({
+    list.Back();
+  }, ListIsEmptyException);
+  list.PushBack(1);
+  list.PushBack(2);
+  list.PushFront(0);
+  list.EmplaceBack(3);
+  ExpectTailList(list, {0, 1, 2, 3});
+  while (!list.IsEmpty()) {
+    list.PopFront();
+  }
+  ExpectTailList(list, {});
+  list.PushBack(4);
+  ExpectTailList(list, {4});
+}
+
+TEST(TailListTest, InsertAndEraseAtEnd) {
+  TailList list{1, 2, 3};
+  ExpectTailList(list, {1, 2, 3});
+  list.InsertAfter(list.BeforeEnd(), 4);
+  ExpectTailList(list, {1, 2, 3, 4});
+  list.EraseAfter(list.Find(3));
+  ExpectTailList(list, {1, 2, 3});
+  TailList copy = list;
+  ExpectTailList(copy, {1, 2, 3});
+  copy.PushBack(5);
+  ExpectTailList(list, {1, 2, 3});
+  TailList sized(2);
+  sized.PushBack(1);
+  ExpectTailList(sized, {0, 0, 1});
+}
+
+TEST(TailListTest, SpliceKeepsTail) {
+  TailList list{1, 2};
+  TailList other{3, 4};
+  list.SpliceBack(other);
+  ExpectTailList(list, {1, 2, 3, 4});
+  ExpectTailList(other, {});
+  other.SpliceBack(list);
+  ExpectTailList(other, {1, 2, 3, 4});
+
+  TailList single{5};
+  other.SpliceAfter(other.BeforeEnd(), single);
+  ExpectTailList(other, {1, 2, 3, 4, 5});
+
+  TailList target{0};
+  target.SpliceAfter(target.Begin(), other, other.Find(4));
+  ExpectTailList(target, {0, 5});
+  ExpectTailList(other, {1, 2, 3, 4});
+  target.SpliceAfter(target.BeforeEnd(), other, other.Find(2), other.End());
+  ExpectTailList(target, {0, 5, 3, 4});
+  ExpectTailList(other, {1, 2});
+}
+
+TEST(TailListTest, BulkOperationsKeepTail) {
+  TailList list{3, 1, 2, 2};
+  list.Sort();
+  ExpectTailList(list, {1, 2, 2, 3});
+  list.Reverse();
+  ExpectTailList(list, {3, 2, 2, 1});
+  list.Unique();
+  ExpectTailList(list, {3, 2, 1});
+  list.RemoveIf([](int x) { return x == 1; });
+  ExpectTailList(list, {3, 2});
+  TailList other{0, 4};
+  list.Sort();
+  list.Merge(other);
+  ExpectTailList(list, {0, 2, 3, 4});
+  list.Compact();
+  ExpectTailList(list, {0, 2, 3, 4});
+  list.PushBack(5);
+  ExpectTailList(list, {0, 2, 3, 4, 5});
+  TailList moved = std::move(list);
+  ExpectTailList(moved, {0, 2, 3, 4, 5});
+  ExpectTailList(list, {});
+  list.Clear();
+  moved.Clear();
+  ExpectTailList(moved, {});
+}
+
+TEST_F(ListTest, FindMany) {
+  const int values[] = {3, 42, 7, 1, 3};
+  ForwardList<int>::ForwardListIterator results[5];
+  ASSERT_EQ(list.FindMany(values, results), 4);
+  for (size_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(results[i], list.Find(values[i]));
+  }
+  ASSERT_EQ(results[1], list.End());
+  ASSERT_EQ(list.FindMany(std::span<const int>(), std::span(results)), 0);
+}
+
+TEST_F(ListTest, PrefetchIterator) {
+  auto expected = list.Begin();
+  for (auto it = list.PrefetchBegin(); it != list.End(); ++it) {
+    ASSERT_EQ(it, expected);
+    ASSERT_EQ(*it, *expected++);
+  }
+  auto it = list.PrefetchBegin();
+  it++;
+  list.EraseAfter(it);
+  ASSERT_EQ(list.Size(), sz - 1);
+}
+
+struct Item : IntrusiveForwardListHook<> {
+  int value;
+
+  explicit Item(int v) : value(v) {
+  }
+
+  bool operator==(const Item& other) const {
+    return value == other.value;
+  }
+};
+
+using ItemList = IntrusiveForwardList<Item>;
+
+void ExpectItems(const ItemList& list, std::initializer_list<int> expected) {
+  ASSERT_EQ(list.Size(), expected.size());
+  auto it = list.Begin();
+  for (int value : expected) {
+    ASSERT_EQ(it->value, value);
+    ++it;
+  }
+  ASSERT_EQ(it, list.End());
+}
+
+TEST(IntrusiveForwardListTest, LinkAndIterate) {
+  Item a(1), b(2), c(3);
+  ItemList list;
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_THROW(list.Front(), ListIsEmptyException);
+  ASSERT_THROW(list.PopFront(), ListIsEmptyException);
+  list.PushFront(c);
+  list.PushFront(a);
+  auto it = list.InsertAfter(list.Begin(), b);
+  ASSERT_EQ(&*it, &b);
+  ExpectItems(list, {1, 2, 3});
+  ASSERT_EQ(&list.Front(), &a);
+  ASSERT_EQ(list.Find(Item(3))->value, 3);
+  ASSERT_EQ(list.Find(Item(4)), list.End());
+  ASSERT_EQ(list.InsertAfter(list.End(), b), list.End());
+}
+
+TEST(IntrusiveForwardListTest, EraseAfter) {
+  Item a(1), b(2), c(3);
+  ItemList list;
+  list.PushFront(c);
+  list.PushFront(b);
+  list.PushFront(a);
+  list.EraseAfter(list.Begin());
+  ExpectItems(list, {1, 3});
+  list.PushFront(b);
+  ExpectItems(list, {2, 1, 3});
+  list.PopFront();
+  list.EraseAfter(list.BeforeBegin());
+  list.EraseAfter(list.Begin());
+  ExpectItems(list, {3});
+  list.Clear();
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(list.Size(), 0);
+}
+
+TEST(IntrusiveForwardListTest, SwapAndMove) {
+  Item a(1), b(2), c(3);
+  Item copy(0);
+  ItemList list;
+  ItemList other;
+  list.PushFront(b);
+  list.PushFront(a);
+  other.PushFront(c);
+  std::swap(list, other);
+  ExpectItems(list, {3});
+  ExpectItems(other, {1, 2});
+  ItemList moved(std::move(other));
+  ExpectItems(moved, {1, 2});
+  ASSERT_TRUE(other.IsEmpty());
+  list = std::move(moved);
+  ExpectItems(list, {1, 2});
+  copy = a;
+  other.PushFront(copy);
+  ExpectItems(other, {1});
+  ExpectItems(list, {1, 2});
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "../../common/epoch_reclamation.hpp"
+
+// Sorted set of unique values shared between threads.
+// Harris-Michael list: Erase marks the low bit of the victim's next pointer
+// and then unlinks it with a CAS; any traversal that meets a marked node helps
+// to unlink it. Contains never writes and never retries.
+// Unlinked nodes are freed with epoch based reclamation, every operation holds
+// a guard of the list's EpochDomain
+template <typename T, typename Compare = std::less<T>>
+class ConcurrentList {
+private:
+    struct Link {
+        // Address of the next node, the low bit marks this node as erased
+        std::atomic<std::uintptr_t> next_;
+
+        Link() : next_(0) {
+        }
+    };
+
+    struct Node : Link {
+        T value_;
+        Node* retired_next_;
+        uint64_t retired_epoch_;
+
+        explicit Node(const T& value) : value_(value), retired_next_(nullptr), retired_epoch_(0) {
+        }
+    };
+
+    using Epochs = EpochDomain<Node>;
+    using Guard = typename Epochs::Guard;
+
+public:
+    explicit ConcurrentList(Compare comp = Compare()) : comp_(std::move(comp)), size_(0) {
+    }
+
+    ConcurrentList(const ConcurrentList&) = delete;
+    ConcurrentList& operator=(const ConcurrentList&) = delete;
+
+    // Returns false if an equal value is already present
+    bool Insert(const T& value) {
+        Guard guard(epochs_);
+        Node* node = nullptr;
+        while (true) {
+            auto [prev, curr] = Search(value, guard);
+            if (curr && !comp_(value, curr->value_)) {
+                delete node;
+                return false;
+            }
+            if (!node) {
+                node = new Node(value);
+            }
+            std::uintptr_t expected = Address(curr);
+            node->next_.store(expected, std::memory_order_relaxed);
+            if (prev->next_.compare_exchange_strong(expected, Address(node), std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                size_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    bool Erase(const T& value) {
+        Guard guard(epochs_);
+        while (true) {
+            auto [prev, curr] = Search(value, guard);
+            if (!curr || comp_(value, curr->value_)) {
+                return false;
+            }
+            std::uintptr_t next = curr->next_.load(std::memory_order_acquire);
+            if (IsMarked(next)) {
+                continue;
+            }
+            // Logical removal: the node is erased once its next pointer is marked
+            if (!curr->next_.compare_exchange_strong(next, next | MarkBit, std::memory_order_acq_rel,
+                                                     std::memory_order_relaxed)) {
+                continue;
+            }
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            std::uintptr_t expected = Address(curr);
+            if (prev->next_.compare_exchange_strong(expected, next, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                epochs_.Retire(curr, guard);
+            } else {
+                Search(value, guard);
+            }
+            return true;
+        }
+    }
+
+    // Lock-free lookup that only reads
+    bool Contains(const T& value) const {
+        Guard guard(epochs_);
+        Node* curr = AsNode(head_.next_.load(std::memory_order_acquire));
+        while (curr && comp_(curr->value_, value)) {
+            curr = AsNode(curr->next_.load(std::memory_order_acquire));
+        }
+        return curr && !comp_(value, curr->value_) && !IsMarked(curr->next_.load(std::memory_order_acquire));
+    }
+
+    // Visits the values in order. Concurrent updates may or may not be observed
+    template <typename Visitor>
+    void ForEach(Visitor visitor) const {
+        Guard guard(epochs_);
+        for (Node* curr = AsNode(head_.next_.load(std::memory_order_acquire)); curr;) {
+            std::uintptr_t next = curr->next_.load(std::memory_order_acquire);
+            if (!IsMarked(next)) {
+                visitor(curr->value_);
+            }
+            curr = AsNode(next);
+        }
+    }
+
+    // Exact when no updates are in flight
+    inline size_t Size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    // Must not run concurrently with other operations
+    ~ConcurrentList() {
+        for (Node* curr = AsNode(head_.next_.load(std::memory_order_relaxed)); curr;) {
+            Node* next = AsNode(curr->next_.load(std::memory_order_relaxed));
+            delete curr;
+            curr = next;
+        }
+    }
+
+private:
+    static constexpr std::uintptr_t MarkBit = 1;
+
+    Link head_;
+    Compare comp_;
+    std::atomic<size_t> size_;
+    Epochs epochs_;
+
+    static std::uintptr_t Address(const Node* node) noexcept {
+        return reinterpret_cast<std::uintptr_t>(node);
+    }
+
+    static bool IsMarked(std::uintptr_t link) noexcept {
+        return (link & MarkBit) != 0;
+    }
+
+    static Node* AsNode(std::uintptr_t link) noexcept {
+        return reinterpret_cast<Node*>(link & ~MarkBit);
+    }
+
+    // Returns the last link before value and the first node not less than value,
+    // unlinking marked nodes on the way
+    std::pair<Link*, Node*> Search(const T& value, const Guard& guard) {
+        while (true) {
+            Link* prev = &head_;
+            Node* curr = AsNode(prev->next_.load(std::memory_order_acquire));
+            bool restart = false;
+            while (curr) {
+                std::uintptr_t next = curr->next_.load(std::memory_order_acquire);
+                if (IsMarked(next)) {
+                    std::uintptr_t expected = Address(curr);
+                    if (!prev->next_.compare_exchange_strong(expected, next & ~MarkBit, std::memory_order_acq_rel,
+                                                             std::memory_order_acquire)) {
+                        restart = true;
+                        break;
+                    }
+                    epochs_.Retire(curr, guard);
+                    curr = AsNode(next);
+                    continue;
+                }
+                if (!comp_(curr->value_, value)) {
+                    return {prev, curr};
+                }
+                prev = curr;
+                curr = AsNode(next);
+            }
+            if (!restart) {
+                return {prev, nullptr};
+            }
+        }
+    }
+};
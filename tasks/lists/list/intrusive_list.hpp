@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// Base of objects that can be linked into an IntrusiveList<T, Tag>; an object derives
+// from one hook per list it can be in at the same time, told apart by Tag.
+// A hook unlinks itself on destruction, so an object may die while linked
+template <typename Tag = void>
+class IntrusiveListHook {
+    template <typename T, typename ListTag>
+    friend class IntrusiveList;
+
+public:
+    IntrusiveListHook() : prev_(nullptr), next_(nullptr), list_size_(nullptr) {
+    }
+
+    // Copying an object does not copy its list membership
+    IntrusiveListHook(const IntrusiveListHook&) : IntrusiveListHook() {
+    }
+
+    IntrusiveListHook& operator=(const IntrusiveListHook&) {
+        return *this;
+    }
+
+    inline bool IsLinked() const noexcept {
+        return next_ != nullptr;
+    }
+
+    // O(1) removal from whatever list the object is in
+    void Unlink() noexcept {
+        if (!IsLinked()) {
+            return;
+        }
+        prev_->next_ = next_;
+        next_->prev_ = prev_;
+        prev_ = next_ = nullptr;
+        --*list_size_;
+        list_size_ = nullptr;
+    }
+
+    ~IntrusiveListHook() {
+        Unlink();
+    }
+
+private:
+    IntrusiveListHook* prev_;
+    IntrusiveListHook* next_;
+    // Size of the list the hook is in, so that unlinking from the object keeps it exact
+    size_t* list_size_;
+
+    void LinkBefore(IntrusiveListHook* pos, size_t* list_size) noexcept {
+        prev_ = pos->prev_;
+        next_ = pos;
+        prev_->next_ = this;
+        pos->prev_ = this;
+        list_size_ = list_size;
+        ++*list_size_;
+    }
+};
+
+// Doubly linked list over objects derived from IntrusiveListHook<Tag>: linking
+// only wires the hook, the list never allocates, copies or destroys elements.
+// Every hook points at the size of its list, so Swap and moves are O(n)
+template <typename T, typename Tag = void>
+class IntrusiveList {
+    using Hook = IntrusiveListHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from IntrusiveListHook<Tag>");
+
+public:
+    class IntrusiveListIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = T;
+        // NOLINTNEXTLINE
+        using reference_type = value_type&;
+        // NOLINTNEXTLINE
+        using pointer_type = value_type*;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        IntrusiveListIterator() : current_(nullptr) {
+        }
+
+        inline bool operator==(const IntrusiveListIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        inline bool operator!=(const IntrusiveListIterator& other) const {
+            return current_ != other.current_;
+        }
+
+        inline reference_type operator*() const {
+            return *FromHook(current_);
+        }
+
+        inline pointer_type operator->() const {
+            return FromHook(current_);
+        }
+
+        IntrusiveListIterator& operator++() {
+            current_ = current_->next_;
+            return *this;
+        }
+
+        IntrusiveListIterator operator++(int) {
+            IntrusiveListIterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        IntrusiveListIterator& operator--() {
+            current_ = current_->prev_;
+            return *this;
+        }
+
+        IntrusiveListIterator operator--(int) {
+            IntrusiveListIterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        friend class IntrusiveList;
+
+    private:
+        Hook* current_;
+
+        explicit IntrusiveListIterator(Hook* hook) : current_(hook) {
+        }
+    };
+
+    IntrusiveList() : size_(0) {
+        end_.prev_ = end_.next_ = &end_;
+    }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    IntrusiveList(IntrusiveList&& other) noexcept : IntrusiveList() {
+        Swap(other);
+    }
+
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    IntrusiveListIterator Begin() const noexcept {
+        return IntrusiveListIterator(end_.next_);
+    }
+
+    IntrusiveListIterator End() const noexcept {
+        return IntrusiveListIterator(&end_);
+    }
+
+    // O(1) iterator to an element that is linked into this list
+    IntrusiveListIterator IteratorTo(T& value) const noexcept {
+        return IntrusiveListIterator(&value);
+    }
+
+    inline T& Front() const {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return *FromHook(end_.next_);
+    }
+
+    inline T& Back() const {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return *FromHook(end_.prev_);
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return end_.next_ == &end_;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    void Swap(IntrusiveList& other) noexcept {
+        Hook* first = end_.next_;
+        Hook* last = end_.prev_;
+        Hook* other_first = other.end_.next_;
+        Hook* other_last = other.end_.prev_;
+        Adopt(other_first, other_last, &other.end_);
+        other.Adopt(first, last, &end_);
+        std::swap(size_, other.size_);
+    }
+
+    // Linking an element that is already in a list moves it
+    void PushFront(T& value) noexcept {
+        Insert(Begin(), value);
+    }
+
+    void PushBack(T& value) noexcept {
+        Insert(End(), value);
+    }
+
+    void PopFront() {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("Cannot pop from an empty list");
+        }
+        end_.next_->Unlink();
+    }
+
+    void PopBack() {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("Cannot pop from an empty list");
+        }
+        end_.prev_->Unlink();
+    }
+
+    // Links value before pos and returns an iterator to it
+    IntrusiveListIterator Insert(IntrusiveListIterator pos, T& value) noexcept {
+        Hook* hook = &value;
+        if (hook == pos.current_) {
+            return pos;
+        }
+        hook->Unlink();
+        hook->LinkBefore(pos.current_, &size_);
+        return IntrusiveListIterator(hook);
+    }
+
+    // Unlinks the element at pos, the object itself stays alive
+    void Erase(IntrusiveListIterator pos) noexcept {
+        if (pos.current_ == &end_) {
+            return;
+        }
+        pos.current_->Unlink();
+    }
+
+    IntrusiveListIterator Find(const T& value) const {
+        for (Hook* curr = end_.next_; curr != &end_; curr = curr->next_) {
+            if (*FromHook(curr) == value) {
+                return IntrusiveListIterator(curr);
+            }
+        }
+        return End();
+    }
+
+    void Clear() noexcept {
+        while (!IsEmpty()) {
+            end_.next_->Unlink();
+        }
+    }
+
+    ~IntrusiveList() {
+        Clear();
+        // The sentinel is not an element, its own destructor must not unlink it
+        end_.prev_ = end_.next_ = nullptr;
+    }
+
+private:
+    mutable Hook end_;
+    size_t size_;
+
+    // Takes the chain [first, last] that used other_end as its sentinel
+    void Adopt(Hook* first, Hook* last, Hook* other_end) noexcept {
+        if (first == other_end) {
+            end_.prev_ = end_.next_ = &end_;
+            return;
+        }
+        end_.next_ = first;
+        end_.prev_ = last;
+        first->prev_ = &end_;
+        last->next_ = &end_;
+        for (Hook* curr = first; curr != &end_; curr = curr->next_) {
+            curr->list_size_ = &size_;
+        }
+    }
+
+    static T* FromHook(Hook* hook) noexcept {
+        return static_cast<T*>(hook);
+    }
+};
+
+namespace std {
+template <typename T, typename Tag>
+// NOLINTNEXTLINE
+void swap(IntrusiveList<T, Tag>& a, IntrusiveList<T, Tag>& b) {
+    a.Swap(b);
+}
+}  // namespace std
@@ -2,31 +2,53 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <functional>
 #include <iterator>
+#include <new>
+#include <span>
 #include <string>
 #include <utility>
 
+#include "../../common/list_prefetch.hpp"
+#include "../../common/node_chunks.hpp"
 #include "exceptions.hpp"
 
 template <typename T>
 class List {
 private:
-    class Node {
+    // Links only: the sentinel is a BaseNode, so T needs no default constructor
+    class BaseNode {
+        friend class ListIterator;
+        friend class List;
+
+        BaseNode* prev_;
+        BaseNode* next_;
+
+        BaseNode() : prev_(this), next_(this) {
+        }
+
+        BaseNode(BaseNode* p, BaseNode* n) : prev_(p), next_(n) {
+        }
+    };
+
+    class Node : public BaseNode {
         friend class ListIterator;
         friend class List;
 
         T data_;
-        Node* prev_;
-        Node* next_;
 
-        explicit Node(const T& value, Node* p = nullptr, Node* n = nullptr) : data_(value), prev_(p), next_(n) {
+        template <typename... Args>
+        explicit Node(BaseNode* p, BaseNode* n, Args&&... args) : BaseNode(p, n), data_(std::forward<Args>(args)...) {
         }
     };
 
+    using Chunks = NodeChunks<Node>;
+
 public:
     class ListIterator {
     public:
@@ -41,6 +63,9 @@ public:
         // NOLINTNEXTLINE
         using iterator_category = std::bidirectional_iterator_tag;
 
+        ListIterator() : current_(nullptr) {
+        }
+
         inline bool operator==(const ListIterator& other) const {
             return current_ == other.current_;
         }
@@ -50,20 +75,15 @@ public:
         }
 
         inline reference_type operator*() const {
-            if (!current_) {
-                throw std::runtime_error("Dereferencing end iterator");
-            }
-            return current_->data_;
+            return AsNode(current_)->data_;
         }
 
         inline pointer_type operator->() const {
-            return &current_->data_;
+            return &AsNode(current_)->data_;
         }
 
         ListIterator& operator++() {
-            if (current_) {
-                current_ = current_->next_;
-            }
+            current_ = current_->next_;
             return *this;
         }
 
@@ -74,11 +94,7 @@ public:
         }
 
         ListIterator& operator--() {
-            if (current_ == nullptr) {
-                current_ = list_->tail_;
-            } else {
-                current_ = current_->prev_;
-            }
+            current_ = current_->prev_;
             return *this;
         }
 
@@ -90,21 +106,25 @@ public:
 
         friend class List<T>;
 
+    protected:
+        const void* NextNode() const noexcept {
+            return current_->next_;
+        }
+
     private:
-        Node* current_;
-        const List* list_;
+        BaseNode* current_;
 
-        explicit ListIterator(Node* node, const List* list) : current_(node), list_(list) {
+        explicit ListIterator(BaseNode* node) : current_(node) {
         }
     };
 
 public:
-    List() : head_(nullptr), tail_(nullptr), size_(0) {
+    List() : size_(0) {
     }
 
     explicit List(size_t sz) : List() {
         for (size_t i = 0; i < sz; ++i) {
-            PushBack(T());
+            EmplaceBack();
         }
     }
 
@@ -115,41 +135,57 @@ public:
     }
 
     List(const List& other) : List() {
-        for (Node* curr = other.head_; curr != nullptr; curr = curr->next_) {
-            PushBack(curr->data_);
+        for (BaseNode* curr = other.end_.next_; curr != &other.end_; curr = curr->next_) {
+            PushBack(AsNode(curr)->data_);
         }
     }
 
     List& operator=(const List& other) {
         if (this != &other) {
             Clear();
-            for (Node* curr = other.head_; curr != nullptr; curr = curr->next_) {
-                PushBack(curr->data_);
+            for (BaseNode* curr = other.end_.next_; curr != &other.end_; curr = curr->next_) {
+                PushBack(AsNode(curr)->data_);
             }
         }
         return *this;
     }
 
+    List(List&& other) noexcept : List() {
+        Splice(End(), other);
+    }
+
+    List& operator=(List&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Splice(End(), other);
+        }
+        return *this;
+    }
+
     ListIterator Begin() const noexcept {
-        return ListIterator(head_, this);
+        return ListIterator(end_.next_);
     }
 
     ListIterator End() const noexcept {
-        return ListIterator(nullptr, this);
+        return ListIterator(&end_);
+    }
+
+    PrefetchIterator<ListIterator> PrefetchBegin() const noexcept {
+        return PrefetchIterator<ListIterator>(Begin());
     }
 
     inline T& Front() const {
         if (IsEmpty()) {
             throw ListIsEmptyException("List is empty");
         }
-        return head_->data_;
+        return AsNode(end_.next_)->data_;
     }
 
     inline T& Back() const {
         if (IsEmpty()) {
             throw ListIsEmptyException("List is empty");
         }
-        return tail_->data_;
+        return AsNode(end_.prev_)->data_;
     }
 
     inline bool IsEmpty() const noexcept {
@@ -160,118 +196,254 @@ public:
         return size_;
     }
 
-    void Swap(List& a) {
-        std::swap(head_, a.head_);
-        std::swap(tail_, a.tail_);
-        std::swap(size_, a.size_);
+    // Bytes held in nodes, counted as requested from the allocator
+    inline size_t MemoryUsage() const noexcept {
+        return size_ * sizeof(Node);
+    }
+
+    // Nodes point at the sentinel inside the object, so swap relinks them
+    void Swap(List& a) noexcept {
+        List temp;
+        temp.Splice(temp.End(), *this);
+        Splice(End(), a);
+        a.Splice(a.End(), temp);
     }
 
     void PushFront(const T& value) {
-        Node* new_node = new Node(value, nullptr, head_);
-        if (IsEmpty()) {
-            head_ = tail_ = new_node;
-        } else {
-            head_->prev_ = new_node;
-            head_ = new_node;
-        }
-        ++size_;
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        return *Emplace(Begin(), std::forward<Args>(args)...);
     }
 
     void PushBack(const T& value) {
-        Node* new_node = new Node(value, tail_, nullptr);
-        if (IsEmpty()) {
-            head_ = tail_ = new_node;
-        } else {
-            tail_->next_ = new_node;
-            tail_ = new_node;
-        }
-        ++size_;
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *Emplace(End(), std::forward<Args>(args)...);
     }
 
     void PopBack() {
         if (IsEmpty()) {
             throw ListIsEmptyException("Cannot pop from an empty list");
         }
-        Node* temp = tail_;
-        tail_ = tail_->prev_;
-        if (tail_) {
-            tail_->next_ = nullptr;
-        } else {
-            head_ = nullptr;
-        }
-        delete temp;
-        --size_;
+        Erase(ListIterator(end_.prev_));
     }
 
     void PopFront() {
         if (IsEmpty()) {
             throw ListIsEmptyException("Cannot pop from an empty list");
         }
-        Node* temp = head_;
-        head_ = head_->next_;
-        if (head_) {
-            head_->prev_ = nullptr;
-        } else {
-            tail_ = nullptr;
-        }
-        delete temp;
-        --size_;
+        Erase(ListIterator(end_.next_));
     }
 
     ListIterator Find(const T& value) const {
-        for (Node* curr = head_; curr != nullptr; curr = curr->next_) {
-            if (curr->data_ == value) {
-                return ListIterator(curr, this);
+        for (BaseNode* curr = end_.next_; curr != &end_; curr = curr->next_) {
+            if (AsNode(curr)->data_ == value) {
+                return ListIterator(curr);
             }
         }
         return End();
     }
 
+    // Looks up all values in a single walk, see FindManyInRange
+    size_t FindMany(std::span<const T> values, std::span<ListIterator> results) const {
+        return FindManyInRange(Begin(), End(), values, results);
+    }
+
     void Erase(ListIterator pos) {
-        if (!pos.current_) {
+        if (pos.current_ == &end_) {
             return;
         }
+        UnlinkRange(pos.current_, pos.current_);
+        DestroyNode(AsNode(pos.current_));
+        --size_;
+    }
+
+    void Insert(ListIterator pos, const T& value) {
+        Emplace(pos, value);
+    }
+
+    void Insert(ListIterator pos, T&& value) {
+        Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    ListIterator Emplace(ListIterator pos, Args&&... args) {
+        BaseNode* next = pos.current_;
+        Node* new_node = new Node(next->prev_, next, std::forward<Args>(args)...);
+        next->prev_->next_ = new_node;
+        next->prev_ = new_node;
+        ++size_;
+        return ListIterator(new_node);
+    }
+
+    void Clear() noexcept {
+        BaseNode* curr = end_.next_;
+        while (curr != &end_) {
+            BaseNode* next = curr->next_;
+            DestroyNode(AsNode(curr));
+            curr = next;
+        }
+        end_.prev_ = end_.next_ = &end_;
+        size_ = 0;
+    }
 
-        Node* node = pos.current_;
-        if (node->prev_) {
-            node->prev_->next_ = node->next_;
+    // Moves all elements of other before pos
+    void Splice(ListIterator pos, List& other) noexcept {
+        if (this == &other || other.IsEmpty()) {
+            return;
         }
-        if (node->next_) {
-            node->next_->prev_ = node->prev_;
+        BaseNode* first = other.end_.next_;
+        BaseNode* last = other.end_.prev_;
+        UnlinkRange(first, last);
+        LinkRangeBefore(pos.current_, first, last);
+        size_ += other.size_;
+        other.size_ = 0;
+    }
+
+    // Moves the element pointed by it from other before pos
+    void Splice(ListIterator pos, List& other, ListIterator it) noexcept {
+        if (it.current_ == &other.end_ || it == pos) {
+            return;
         }
-        if (node == head_) {
-            head_ = node->next_;
+        UnlinkRange(it.current_, it.current_);
+        LinkRangeBefore(pos.current_, it.current_, it.current_);
+        --other.size_;
+        ++size_;
+    }
+
+    // Moves [first, last) from other before pos. Relinking is O(1), moving
+    // a range between different lists also counts it to keep Size() exact
+    void Splice(ListIterator pos, List& other, ListIterator first, ListIterator last) noexcept {
+        if (first == last) {
+            return;
         }
-        if (node == tail_) {
-            tail_ = node->prev_;
+        BaseNode* last_node = last.current_->prev_;
+        if (this != &other) {
+            size_t count = 1;
+            for (BaseNode* curr = first.current_; curr != last_node; curr = curr->next_) {
+                ++count;
+            }
+            other.size_ -= count;
+            size_ += count;
         }
+        UnlinkRange(first.current_, last_node);
+        LinkRangeBefore(pos.current_, first.current_, last_node);
+    }
 
-        delete node;
-        --size_;
+    // Merges sorted other into this sorted list, other becomes empty. If comp
+    // throws, all elements of both lists stay in this one in unspecified order
+    template <typename Compare = std::less<T>>
+    void Merge(List& other, Compare comp = Compare()) {
+        if (this == &other || other.IsEmpty()) {
+            return;
+        }
+        BaseNode* a = DetachChain();
+        BaseNode* b = other.DetachChain();
+        size_ += other.size_;
+        other.size_ = 0;
+        try {
+            AttachChain(MergeChains(a, b, comp));
+        } catch (...) {
+            AttachChain(a);
+            throw;
+        }
     }
 
-    void Insert(ListIterator pos, const T& value) {
-        if (!pos.current_) {
-            PushBack(value);
+    // Stable bottom-up merge sort, relinks nodes without allocations. If comp
+    // throws, the elements are kept in unspecified order
+    template <typename Compare = std::less<T>>
+    void Sort(Compare comp = Compare()) {
+        if (size_ < 2) {
             return;
         }
+        BaseNode* chain = DetachChain();
+        try {
+            chain = SortChain(chain, comp);
+        } catch (...) {
+            AttachChain(chain);
+            throw;
+        }
+        AttachChain(chain);
+    }
+
+    void Reverse() noexcept {
+        BaseNode* curr = &end_;
+        do {
+            std::swap(curr->prev_, curr->next_);
+            curr = curr->prev_;
+        } while (curr != &end_);
+    }
+
+    // Removes consecutive duplicates, returns the number of removed elements
+    size_t Unique() {
+        return UniqueIf(std::equal_to<T>());
+    }
 
-        Node* new_node = new Node(value, pos.current_->prev_, pos.current_);
-        if (pos.current_->prev_) {
-            pos.current_->prev_->next_ = new_node;
+    template <typename BinaryPredicate>
+    size_t UniqueIf(BinaryPredicate pred) {
+        size_t removed = 0;
+        BaseNode* curr = end_.next_;
+        while (curr != &end_ && curr->next_ != &end_) {
+            if (pred(AsNode(curr)->data_, AsNode(curr->next_)->data_)) {
+                Erase(ListIterator(curr->next_));
+                ++removed;
+            } else {
+                curr = curr->next_;
+            }
         }
-        pos.current_->prev_ = new_node;
+        return removed;
+    }
 
-        if (pos.current_ == head_) {
-            head_ = new_node;
+    template <typename Predicate>
+    size_t RemoveIf(Predicate pred) {
+        size_t removed = 0;
+        for (BaseNode* curr = end_.next_; curr != &end_;) {
+            BaseNode* next = curr->next_;
+            if (pred(AsNode(curr)->data_)) {
+                Erase(ListIterator(curr));
+                ++removed;
+            }
+            curr = next;
         }
-        ++size_;
+        return removed;
     }
 
-    void Clear() noexcept {
-        while (!IsEmpty()) {
-            PopFront();
+    // Moves the elements into freshly allocated chunks in traversal order and
+    // frees the old nodes, so iteration walks memory sequentially.
+    // Invalidates all iterators, pointers and references to elements
+    void Compact() {
+        List compacted;
+        typename Chunks::Filler filler;
+        for (BaseNode* curr = end_.next_; curr != &end_; curr = curr->next_) {
+            void* slot = filler.Acquire();
+            Node* node;
+            try {
+                node = new (slot)
+                    Node(compacted.end_.prev_, &compacted.end_, std::move_if_noexcept(AsNode(curr)->data_));
+            } catch (...) {
+                Chunks::Release(slot);
+                throw;
+            }
+            compacted.end_.prev_->next_ = node;
+            compacted.end_.prev_ = node;
+            ++compacted.size_;
         }
+        Clear();
+        Splice(End(), compacted);
     }
 
     ~List() {
@@ -279,9 +451,136 @@ public:
     }
 
 private:
-    Node* head_;
-    Node* tail_;
+    // Circular sentinel: end_.next_ is the head, end_.prev_ is the tail
+    mutable BaseNode end_;
     size_t size_;
+
+    static constexpr size_t SortBuckets = 64;
+
+    static Node* AsNode(BaseNode* node) noexcept {
+        return static_cast<Node*>(node);
+    }
+
+    static void DestroyNode(Node* node) noexcept {
+        if (!Chunks::Owns(node)) {
+            delete node;
+            return;
+        }
+        node->~Node();
+        Chunks::Release(node);
+    }
+
+    static void UnlinkRange(BaseNode* first, BaseNode* last) noexcept {
+        first->prev_->next_ = last->next_;
+        last->next_->prev_ = first->prev_;
+    }
+
+    static void LinkRangeBefore(BaseNode* pos, BaseNode* first, BaseNode* last) noexcept {
+        BaseNode* prev = pos->prev_;
+        first->prev_ = prev;
+        last->next_ = pos;
+        prev->next_ = first;
+        pos->prev_ = last;
+    }
+
+    // Turns the ring into a nullptr-terminated chain linked by next_ only
+    BaseNode* DetachChain() noexcept {
+        if (IsEmpty()) {
+            return nullptr;
+        }
+        BaseNode* head = end_.next_;
+        end_.prev_->next_ = nullptr;
+        end_.prev_ = end_.next_ = &end_;
+        return head;
+    }
+
+    void AttachChain(BaseNode* head) noexcept {
+        BaseNode* prev = &end_;
+        for (BaseNode* curr = head; curr != nullptr; curr = curr->next_) {
+            curr->prev_ = prev;
+            prev->next_ = curr;
+            prev = curr;
+        }
+        prev->next_ = &end_;
+        end_.prev_ = prev;
+    }
+
+    // Appends chain b to chain a
+    static BaseNode* Concat(BaseNode* a, BaseNode* b) noexcept {
+        if (!a) {
+            return b;
+        }
+        BaseNode* tail = a;
+        while (tail->next_) {
+            tail = tail->next_;
+        }
+        tail->next_ = b;
+        return a;
+    }
+
+    // Merges two nullptr-terminated sorted chains, ties keep a first. Both chains
+    // are consumed. If comp throws, a holds every node of both and b is empty
+    template <typename Compare>
+    static BaseNode* MergeChains(BaseNode*& a, BaseNode*& b, Compare& comp) {
+        BaseNode* head = nullptr;
+        BaseNode** link = &head;
+        try {
+            while (a && b) {
+                if (comp(AsNode(b)->data_, AsNode(a)->data_)) {
+                    *link = b;
+                    b = b->next_;
+                } else {
+                    *link = a;
+                    a = a->next_;
+                }
+                link = &(*link)->next_;
+            }
+        } catch (...) {
+            *link = Concat(a, b);
+            a = head;
+            b = nullptr;
+            throw;
+        }
+        *link = a ? a : b;
+        a = b = nullptr;
+        return head;
+    }
+
+    // buckets[i] holds a sorted run of 2^i nodes, so no extra memory is needed.
+    // If comp throws, head holds every node again
+    template <typename Compare>
+    static BaseNode* SortChain(BaseNode*& head, Compare& comp) {
+        BaseNode* buckets[SortBuckets] = {};
+        size_t used = 0;
+        BaseNode* carry = nullptr;
+        BaseNode* result = nullptr;
+        try {
+            while (head) {
+                carry = head;
+                head = head->next_;
+                carry->next_ = nullptr;
+                size_t i = 0;
+                for (; i < used && buckets[i]; ++i) {
+                    carry = MergeChains(buckets[i], carry, comp);
+                }
+                if (i == used) {
+                    ++used;
+                }
+                buckets[i] = carry;
+                carry = nullptr;
+            }
+            for (size_t i = 0; i < used; ++i) {
+                result = MergeChains(buckets[i], result, comp);
+            }
+        } catch (...) {
+            head = Concat(Concat(carry, result), head);
+            for (size_t i = 0; i < used; ++i) {
+                head = Concat(buckets[i], head);
+            }
+            throw;
+        }
+        return result;
+    }
 };
 
 namespace std {
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "list.hpp"
+
+// Default weigher: every entry weighs 1, so the capacity is an entry count
+struct LruEntryCount {
+    template <typename Key, typename Value>
+    size_t operator()(const Key&, const Value&) const noexcept {
+        return 1;
+    }
+};
+
+// Least recently used cache: entries live in a List ordered from the most to the
+// least recently used one and a hash index points at their nodes. A hit relinks
+// the node to the front without allocating. A Weigher returning the size of an
+// entry in bytes turns the capacity into a byte budget
+template <typename Key, typename Value, typename Weigher = LruEntryCount, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class LruCache {
+private:
+    struct Entry {
+        Key key_;
+        Value value_;
+        size_t weight_;
+    };
+
+    using EntryIterator = typename List<Entry>::ListIterator;
+
+public:
+    explicit LruCache(size_t capacity, Weigher weigher = Weigher())
+        : capacity_(capacity), weight_(0), hits_(0), misses_(0), evictions_(0), weigher_(std::move(weigher)) {
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // Returns the cached value and marks it as the most recently used one, nullptr on a miss
+    Value* Get(const Key& key) {
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        entries_.Splice(entries_.Begin(), entries_, found->second);
+        return &found->second->value_;
+    }
+
+    // Looks the key up without touching the recency order or the counters
+    const Value* Peek(const Key& key) const {
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            return nullptr;
+        }
+        return &found->second->value_;
+    }
+
+    bool Contains(const Key& key) const {
+        return index_.find(key) != index_.end();
+    }
+
+    // Inserts or replaces the value and evicts from the back until the cache fits.
+    // An entry heavier than the whole capacity is evicted right away
+    void Put(const Key& key, Value value) {
+        size_t weight = weigher_(key, value);
+        auto found = index_.find(key);
+        if (found != index_.end()) {
+            Entry& entry = *found->second;
+            entry.value_ = std::move(value);
+            weight_ = weight_ - entry.weight_ + weight;
+            entry.weight_ = weight;
+            entries_.Splice(entries_.Begin(), entries_, found->second);
+        } else {
+            Entry& entry = entries_.EmplaceFront(Entry{key, std::move(value), weight});
+            try {
+                index_.emplace(entry.key_, entries_.Begin());
+            } catch (...) {
+                entries_.PopFront();
+                throw;
+            }
+            weight_ += weight;
+        }
+        Shrink(capacity_);
+    }
+
+    bool Erase(const Key& key) {
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            return false;
+        }
+        EntryIterator it = found->second;
+        index_.erase(found);
+        weight_ -= it->weight_;
+        entries_.Erase(it);
+        return true;
+    }
+
+    // Changes the budget, evicting entries if it shrinks
+    void SetCapacity(size_t capacity) {
+        capacity_ = capacity;
+        Shrink(capacity_);
+    }
+
+    void Clear() noexcept {
+        index_.clear();
+        entries_.Clear();
+        weight_ = 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return entries_.Size();
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return entries_.IsEmpty();
+    }
+
+    inline size_t Weight() const noexcept {
+        return weight_;
+    }
+
+    inline size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    inline size_t Hits() const noexcept {
+        return hits_;
+    }
+
+    inline size_t Misses() const noexcept {
+        return misses_;
+    }
+
+    inline size_t Evictions() const noexcept {
+        return evictions_;
+    }
+
+    void ResetStats() noexcept {
+        hits_ = misses_ = evictions_ = 0;
+    }
+
+private:
+    List<Entry> entries_;
+    std::unordered_map<Key, EntryIterator, Hash, KeyEqual> index_;
+    size_t capacity_;
+    size_t weight_;
+    size_t hits_;
+    size_t misses_;
+    size_t evictions_;
+    Weigher weigher_;
+
+    void Shrink(size_t limit) {
+        while (weight_ > limit && !entries_.IsEmpty()) {
+            Entry& victim = entries_.Back();
+            index_.erase(victim.key_);
+            weight_ -= victim.weight_;
+            entries_.PopBack();
+            ++evictions_;
+        }
+    }
+};
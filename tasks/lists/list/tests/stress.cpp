@@ -1,11 +1,20 @@
+#include <cmath>
 #include <random>
 #include <list>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
 
+#include "../intrusive_list.hpp"
+#include "../concurrent_list.hpp"
 #include "../list.hpp"
+#include "../lru_cache.hpp"
+#include "../xor_list.hpp"
+#include "../../../common/mixed_workload.hpp"
 
 void ConstructRandomList(List<int>& list, int sz) {
   std::random_device rd;
@@ -143,6 +152,547 @@ void BM_StdListFind(benchmark::State& state) {
 }
 
 
+const size_t PayloadLength = 64;
+
+void BM_CustomListPushBackStringCopy(benchmark::State& state) {
+  for (auto _ : state) {
+    List<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      std::string payload(PayloadLength, 'a' + i % 26);
+      list.PushBack(payload);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListPushBackStringMove(benchmark::State& state) {
+  for (auto _ : state) {
+    List<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      std::string payload(PayloadLength, 'a' + i % 26);
+      list.PushBack(std::move(payload));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListEmplaceBackString(benchmark::State& state) {
+  for (auto _ : state) {
+    List<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.EmplaceBack(PayloadLength, 'a' + i % 26);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListEmplaceBackString(benchmark::State& state) {
+  for (auto _ : state) {
+    std::list<std::string> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.emplace_back(PayloadLength, 'a' + i % 26);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+void BM_CustomListSort(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    List<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    list.Sort();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListCopySortRebuild(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    List<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    std::vector<int> values(list.Begin(), list.End());
+    std::sort(values.begin(), values.end());
+    list.Clear();
+    for (int value : values) {
+      list.PushBack(value);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListSort(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::list<int> list;
+    ConstructRandomList(list, state.range(0));
+    state.ResumeTiming();
+    list.sort();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+void BM_CustomListPushPopBothEnds(benchmark::State& state) {
+  List<int> list;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.PushBack(i);
+      list.PushFront(i);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.PopBack();
+      list.PopFront();
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListPushPopBothEnds(benchmark::State& state) {
+  std::list<int> list;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.push_back(i);
+      list.push_front(i);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.pop_back();
+      list.pop_front();
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListMiddleInsertErase(benchmark::State& state) {
+  List<int> list;
+  ConstructRandomList(list, 100);
+  auto it = list.Begin();
+  std::advance(it, 50);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.Insert(it, 50);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      auto prev = it;
+      list.Erase(--prev);
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_StdListMiddleInsertErase(benchmark::State& state) {
+  std::list<int> list;
+  ConstructRandomList(list, 100);
+  auto it = list.begin();
+  std::advance(it, 50);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.insert(it, 50);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.erase(std::prev(it));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Sorting random values relinks the nodes, so traversal order becomes random in memory
+void ConstructFragmentedList(List<int>& list, int sz) {
+  ConstructRandomList(list, sz);
+  list.Sort();
+}
+
+int64_t TraverseList(const List<int>& list) {
+  int64_t sum = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    sum += *it;
+  }
+  return sum;
+}
+
+void BM_CustomListTraverseFragmented(benchmark::State& state) {
+  List<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TraverseList(list));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraverseCompacted(benchmark::State& state) {
+  List<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  list.Compact();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TraverseList(list));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListCompact(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    List<int> list;
+    ConstructFragmentedList(list, state.range(0));
+    state.ResumeTiming();
+    list.Compact();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+// Half of the queries hit elements spread over the whole list, the rest most likely miss
+std::vector<int> RandomQueries(const List<int>& list, int64_t count) {
+  std::mt19937 mt(count);
+  std::vector<int> queries;
+  int64_t step = static_cast<int64_t>(list.Size()) / count * 2;
+  int64_t pos = 0;
+  for (auto it = list.Begin(); it != list.End() && static_cast<int64_t>(queries.size()) < count / 2; ++it, ++pos) {
+    if (pos % step == step - 1) {
+      queries.push_back(*it);
+    }
+  }
+  while (static_cast<int64_t>(queries.size()) < count) {
+    queries.push_back(static_cast<int>(mt()));
+  }
+  return queries;
+}
+
+void BM_CustomListFindEach(benchmark::State& state) {
+  List<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  std::vector<int> queries = RandomQueries(list, state.range(1));
+  for (auto _ : state) {
+    for (int query : queries) {
+      benchmark::DoNotOptimize(list.Find(query));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListFindMany(benchmark::State& state) {
+  List<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  std::vector<int> queries = RandomQueries(list, state.range(1));
+  std::vector<List<int>::ListIterator> results(queries.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(list.FindMany(queries, results));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraversePrefetch(benchmark::State& state) {
+  List<int> list;
+  ConstructFragmentedList(list, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = list.PrefetchBegin(); it != list.End(); ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+struct PooledItem : IntrusiveListHook<> {
+  int value;
+
+  explicit PooledItem(int v) : value(v) {
+  }
+
+  bool operator==(const PooledItem& other) const {
+    return value == other.value;
+  }
+};
+
+using PooledItemList = IntrusiveList<PooledItem>;
+
+std::vector<PooledItem> ConstructItems(int64_t size) {
+  std::vector<PooledItem> items;
+  items.reserve(size);
+  for (int64_t i = 0; i < size; ++i) {
+    items.emplace_back(static_cast<int>(i));
+  }
+  return items;
+}
+
+void BM_IntrusiveListLinkTraverse(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    PooledItemList list;
+    for (auto& item : items) {
+      list.PushBack(item);
+    }
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += it->value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListPointerLinkTraverse(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    List<PooledItem*> list;
+    for (auto& item : items) {
+      list.PushBack(&item);
+    }
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += (*it)->value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+constexpr size_t EraseStep = 16;
+
+// Removes every EraseStep-th object: the object unlinks itself, the pointer list has to find it first
+void BM_IntrusiveListErase(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    PooledItemList list;
+    for (auto& item : items) {
+      list.PushBack(item);
+    }
+    state.ResumeTiming();
+    for (size_t i = 0; i < items.size(); i += EraseStep) {
+      items[i].Unlink();
+    }
+    benchmark::DoNotOptimize(list.Begin());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListPointerErase(benchmark::State& state) {
+  std::vector<PooledItem> items = ConstructItems(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    List<PooledItem*> list;
+    for (auto& item : items) {
+      list.PushBack(&item);
+    }
+    state.ResumeTiming();
+    for (size_t i = 0; i < items.size(); i += EraseStep) {
+      list.Erase(list.Find(&items[i]));
+    }
+    benchmark::DoNotOptimize(list.Begin());
+    state.PauseTiming();
+    list.Clear();
+    state.ResumeTiming();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template <typename ListType>
+void BM_TraverseInts(benchmark::State& state) {
+  ListType list;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    list.PushBack(static_cast<int>(i));
+  }
+  state.counters["bytes_per_element"] =
+      static_cast<double>(list.MemoryUsage()) / static_cast<double>(state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto it = list.Begin(); it != list.End(); ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListTraverseInts(benchmark::State& state) {
+  BM_TraverseInts<List<int>>(state);
+}
+
+void BM_XorListTraverseInts(benchmark::State& state) {
+  BM_TraverseInts<XorList<int>>(state);
+}
+
+void BM_XorListPushBack(benchmark::State& state) {
+  for (auto _ : state) {
+    XorList<int> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.PushBack(static_cast<int>(i));
+    }
+    benchmark::DoNotOptimize(list.Back());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomListPushBackClear(benchmark::State& state) {
+  for (auto _ : state) {
+    List<int> list;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      list.PushBack(static_cast<int>(i));
+    }
+    benchmark::DoNotOptimize(list.Back());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+constexpr int ZipfKeys = 1 << 20;
+constexpr int ZipfQueries = 1 << 20;
+constexpr double ZipfSkew = 0.99;
+
+// Keys drawn from a Zipfian distribution over [0, ZipfKeys), shuffled so hot keys are not adjacent
+std::vector<int> ZipfianQueries() {
+  std::mt19937 mt(ZipfQueries);
+  std::vector<double> cdf(ZipfKeys);
+  double total = 0;
+  for (int i = 0; i < ZipfKeys; ++i) {
+    total += 1.0 / std::pow(i + 1, ZipfSkew);
+    cdf[i] = total;
+  }
+  std::vector<int> permutation(ZipfKeys);
+  for (int i = 0; i < ZipfKeys; ++i) {
+    permutation[i] = i;
+  }
+  std::shuffle(permutation.begin(), permutation.end(), mt);
+  std::uniform_real_distribution<double> dist(0, total);
+  std::vector<int> queries(ZipfQueries);
+  for (auto& query : queries) {
+    auto rank = std::lower_bound(cdf.begin(), cdf.end(), dist(mt)) - cdf.begin();
+    query = permutation[std::min<int64_t>(rank, ZipfKeys - 1)];
+  }
+  return queries;
+}
+
+const std::vector<int>& CachedZipfianQueries() {
+  static const std::vector<int> queries = ZipfianQueries();
+  return queries;
+}
+
+// The usual hand-rolled cache the LruCache replaces
+class StdLruCache {
+public:
+  explicit StdLruCache(size_t capacity) : capacity_(capacity) {
+  }
+
+  int64_t* Get(int key) {
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return &found->second->second;
+  }
+
+  void Put(int key, int64_t value) {
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      found->second->second = value;
+      entries_.splice(entries_.begin(), entries_, found->second);
+      return;
+    }
+    entries_.emplace_front(key, value);
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+private:
+  std::list<std::pair<int, int64_t>> entries_;
+  std::unordered_map<int, std::list<std::pair<int, int64_t>>::iterator> index_;
+  size_t capacity_;
+};
+
+template <typename Cache>
+void RunZipfianWorkload(benchmark::State& state) {
+  const std::vector<int>& queries = CachedZipfianQueries();
+  int64_t hits = 0;
+  for (auto _ : state) {
+    Cache cache(state.range(0));
+    hits = 0;
+    for (int key : queries) {
+      if (int64_t* value = cache.Get(key)) {
+        benchmark::DoNotOptimize(*value);
+        ++hits;
+      } else {
+        cache.Put(key, key);
+      }
+    }
+  }
+  state.counters["hit_ratio"] = static_cast<double>(hits) / static_cast<double>(queries.size());
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+
+void BM_CustomLruCacheZipfian(benchmark::State& state) {
+  RunZipfianWorkload<LruCache<int, int64_t>>(state);
+}
+
+void BM_StdLruCacheZipfian(benchmark::State& state) {
+  RunZipfianWorkload<StdLruCache>(state);
+}
+
+constexpr int ConcurrentKeys = 1 << 10;
+
+// The baseline: one mutex around a sorted List
+class LockedSortedList {
+public:
+  bool Contains(int value) {
+    std::lock_guard lock(mutex_);
+    auto it = LowerBound(value);
+    return it != list_.End() && *it == value;
+  }
+
+  bool Insert(int value) {
+    std::lock_guard lock(mutex_);
+    auto it = LowerBound(value);
+    if (it != list_.End() && *it == value) {
+      return false;
+    }
+    list_.Insert(it, value);
+    return true;
+  }
+
+  bool Erase(int value) {
+    std::lock_guard lock(mutex_);
+    auto it = LowerBound(value);
+    if (it == list_.End() || *it != value) {
+      return false;
+    }
+    list_.Erase(it);
+    return true;
+  }
+
+private:
+  std::mutex mutex_;
+  List<int> list_;
+
+  List<int>::ListIterator LowerBound(int value) {
+    auto it = list_.Begin();
+    while (it != list_.End() && *it < value) {
+      ++it;
+    }
+    return it;
+  }
+};
+
+bool InsertKey(auto& set, int key) {
+  return set.Insert(key);
+}
+
+void BM_ConcurrentListMixed(benchmark::State& state) {
+  RunMixedWorkload<ConcurrentList<int>>(state, ConcurrentKeys, InsertKey<ConcurrentList<int>>);
+}
+
+void BM_LockedListMixed(benchmark::State& state) {
+  RunMixedWorkload<LockedSortedList>(state, ConcurrentKeys, InsertKey<LockedSortedList>);
+}
+
 BENCHMARK(BM_CustomListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListPushBack)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomListMiddleInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
@@ -154,5 +704,41 @@ BENCHMARK(BM_StdListClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::k
 BENCHMARK(BM_CustomListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdListFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_CustomListPushBackStringCopy)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListPushBackStringMove)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListEmplaceBackString)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListEmplaceBackString)->Range(1<<10, 1<<18)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListSort)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListCopySortRebuild)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListSort)->Range(1<<10, 1<<20)->Complexity(benchmark::oNLogN)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListPushPopBothEnds)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListPushPopBothEnds)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListMiddleInsertErase)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdListMiddleInsertErase)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListTraverseFragmented)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraverseCompacted)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListCompact)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomListFindEach)->Ranges({{1<<12, 1<<21}, {4, 16}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListFindMany)->Ranges({{1<<12, 1<<21}, {4, 16}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraversePrefetch)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_IntrusiveListLinkTraverse)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListPointerLinkTraverse)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IntrusiveListErase)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListPointerErase)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListTraverseInts)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_XorListTraverseInts)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomListPushBackClear)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_XorListPushBack)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_CustomLruCacheZipfian)->Range(1<<10, 1<<18)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdLruCacheZipfian)->Range(1<<10, 1<<18)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ConcurrentListMixed)->Arg(50)->Arg(90)->Arg(99)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_LockedListMixed)->Arg(50)->Arg(90)->Arg(99)->ThreadRange(1, 8)->UseRealTime();
 
 BENCHMARK_MAIN();
\ No newline at end of file
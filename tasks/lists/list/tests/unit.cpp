@@ -1,11 +1,21 @@
 #include <list>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <span>
+#include <string>
 #include <thread>
+#include <vector>
 #include <future>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
+#include "../intrusive_list.hpp"
+#include "../concurrent_list.hpp"
 #include "../list.hpp"
+#include "../lru_cache.hpp"
+#include "../xor_list.hpp"
 
 class ListTest: public testing::Test {
   protected:
@@ -275,6 +285,663 @@ TEST_F(ListTest, Clear) {
   ASSERT_EQ(list.Size(), 0);
 }
 
+TEST(EmptyListTest, PushMoveOnly) {
+  List<std::unique_ptr<int>> list;
+  list.PushBack(std::make_unique<int>(2));
+  list.PushFront(std::make_unique<int>(1));
+  ASSERT_EQ(list.Size(), 2);
+  ASSERT_EQ(*list.Front(), 1);
+  ASSERT_EQ(*list.Back(), 2);
+}
+
+TEST(EmptyListTest, EmplaceInPlace) {
+  List<std::string> list;
+  ASSERT_EQ(list.EmplaceBack(3, 'b'), "bbb");
+  ASSERT_EQ(list.EmplaceFront(2, 'a'), "aa");
+  auto it = list.Emplace(list.End(), "d");
+  ASSERT_EQ(*it, "d");
+  it = list.Emplace(it, 1, 'c');
+  ASSERT_EQ(*it, "c");
+  ASSERT_EQ(list.Size(), 4);
+  std::string expected[] = {"aa", "bbb", "c", "d"};
+  size_t i = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected[i++]);
+  }
+  ASSERT_EQ(list.Back(), "d");
+}
+
+TEST_F(ListTest, MoveConstructor) {
+  List<int> lst = std::move(list);
+  ASSERT_EQ(lst.Size(), sz);
+  ASSERT_TRUE(list.IsEmpty());
+  int iter = 1;
+  for (auto it = lst.Begin(); it != lst.End(); ++it) {
+    ASSERT_EQ(*it, iter++);
+  }
+}
+
+TEST_F(ListTest, MoveAssigment) {
+  List<int> lst{10, 20};
+  lst = std::move(list);
+  ASSERT_EQ(lst.Size(), sz);
+  ASSERT_EQ(lst.Front(), 1);
+  ASSERT_EQ(lst.Back(), 7);
+  ASSERT_TRUE(list.IsEmpty());
+  list.PushBack(1);
+  ASSERT_EQ(list.Front(), list.Back());
+}
+
+template <typename T>
+void ExpectListEq(const List<T>& list, std::initializer_list<T> expected) {
+  ASSERT_EQ(list.Size(), expected.size());
+  auto it = list.Begin();
+  for (const auto& value : expected) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  ASSERT_EQ(it, list.End());
+  for (auto rit = std::rbegin(expected); rit != std::rend(expected); ++rit) {
+    --it;
+    ASSERT_EQ(*it, *rit);
+  }
+}
+
+TEST(EmptyListTest, SortStable) {
+  List<std::pair<int, int>> list{{3, 0}, {1, 1}, {2, 2}, {1, 3}, {3, 4}, {0, 5}};
+  list.Sort([](const auto& a, const auto& b) { return a.first < b.first; });
+  ExpectListEq<std::pair<int, int>>(list, {{0, 5}, {1, 1}, {1, 3}, {2, 2}, {3, 0}, {3, 4}});
+  ASSERT_EQ(list.Back(), std::make_pair(3, 4));
+}
+
+TEST(EmptyListTest, SortLarge) {
+  List<int> list;
+  for (int i = 0; i < 1000; ++i) {
+    list.PushBack((i * 7919) % 1000);
+  }
+  list.Sort();
+  int expected = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, expected++);
+  }
+  ASSERT_EQ(list.Back(), 999);
+}
+
+TEST(EmptyListTest, Merge) {
+  List<int> list{1, 4, 6};
+  List<int> other{2, 3, 5, 7};
+  list.Merge(other);
+  ASSERT_TRUE(other.IsEmpty());
+  ExpectListEq(list, {1, 2, 3, 4, 5, 6, 7});
+}
+
+TEST(EmptyListTest, ThrowingComparatorKeepsElements) {
+  for (int throw_after : {0, 5, 50, 300}) {
+    List<int> list;
+    List<int> other;
+    for (int i = 0; i < 200; ++i) {
+      list.PushBack((i * 7919) % 200);
+      other.PushBack(i);
+    }
+    int calls = 0;
+    auto comp = [&calls, throw_after](int a, int b) {
+      if (calls++ == throw_after) {
+        throw std::runtime_error("comparator");
+      }
+      return a < b;
+    };
+    ASSERT_THROW(list.Sort(comp), std::runtime_error);
+    ASSERT_EQ(list.Size(), 200);
+    ASSERT_EQ(std::accumulate(list.Begin(), list.End(), 0), 199 * 100);
+    int backward = 0;
+    for (auto it = list.End(); it != list.Begin();) {
+      backward += *--it;
+    }
+    ASSERT_EQ(backward, 199 * 100);
+    calls = 0;
+    list.Sort();
+    ASSERT_THROW(list.Merge(other, comp), std::runtime_error);
+    ASSERT_TRUE(other.IsEmpty());
+    ASSERT_EQ(list.Size(), 400);
+    ASSERT_EQ(std::accumulate(list.Begin(), list.End(), 0), 2 * 199 * 100);
+  }
+}
+
+TEST_F(ListTest, SpliceWholeList) {
+  List<int> other{10, 11};
+  auto it = list.Begin();
+  ++it;
+  list.Splice(it, other);
+  ASSERT_TRUE(other.IsEmpty());
+  ExpectListEq(list, {1, 10, 11, 2, 3, 4, 5, 6, 7});
+  List<int> tail{12};
+  list.Splice(list.End(), tail);
+  ASSERT_EQ(list.Back(), 12);
+}
+
+TEST_F(ListTest, SpliceElementAndRange) {
+  List<int> other{10, 11, 12, 13};
+  list.Splice(list.Begin(), other, other.Begin());
+  ExpectListEq(list, {10, 1, 2, 3, 4, 5, 6, 7});
+  ExpectListEq(other, {11, 12, 13});
+
+  auto first = other.Begin();
+  ++first;
+  list.Splice(list.End(), other, first, other.End());
+  ExpectListEq(list, {10, 1, 2, 3, 4, 5, 6, 7, 12, 13});
+  ExpectListEq(other, {11});
+
+  auto last = list.Begin();
+  std::advance(last, 3);
+  list.Splice(list.End(), list, list.Begin(), last);
+  ExpectListEq(list, {3, 4, 5, 6, 7, 12, 13, 10, 1, 2});
+}
+
+TEST_F(ListTest, Reverse) {
+  list.Reverse();
+  ExpectListEq(list, {7, 6, 5, 4, 3, 2, 1});
+}
+
+TEST(EmptyListTest, UniqueAndRemoveIf) {
+  List<int> list{1, 1, 2, 2, 2, 3, 1, 1};
+  ASSERT_EQ(list.Unique(), 4);
+  ExpectListEq(list, {1, 2, 3, 1});
+  ASSERT_EQ(list.RemoveIf([](int x) { return x == 1; }), 2);
+  ExpectListEq(list, {2, 3});
+}
+
+TEST_F(ListTest, CompactKeepsOrder) {
+  list.Sort(std::greater<int>());
+  list.Compact();
+  ExpectListEq(list, {7, 6, 5, 4, 3, 2, 1});
+  list.Erase(list.Find(4));
+  list.PopFront();
+  list.PushBack(0);
+  list.Compact();
+  ExpectListEq(list, {6, 5, 3, 2, 1, 0});
+}
+
+TEST(EmptyListTest, CompactLargeAndSplice) {
+  List<std::string> list;
+  for (int i = 0; i < 10000; ++i) {
+    list.PushBack(std::to_string(i));
+  }
+  list.Compact();
+  ASSERT_EQ(list.Size(), 10000);
+  int expected = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    ASSERT_EQ(*it, std::to_string(expected++));
+  }
+
+  List<std::string> other;
+  auto last = list.Begin();
+  std::advance(last, 5000);
+  other.Splice(other.End(), list, list.Begin(), last);
+  ASSERT_EQ(other.Size(), 5000);
+  ASSERT_EQ(list.Front(), "5000");
+  list.Clear();
+  ASSERT_EQ(other.Back(), "4999");
+}
+
+TEST_F(ListTest, MemoryUsage) {
+  List<int> single;
+  ASSERT_EQ(single.MemoryUsage(), 0);
+  single.PushBack(1);
+  size_t node = single.MemoryUsage();
+  ASSERT_GE(node, sizeof(int) + 2 * sizeof(void*));
+  ASSERT_EQ(list.MemoryUsage(), list.Size() * node);
+}
+
+TEST_F(ListTest, FindMany) {
+  const int values[] = {3, 42, 7, 1, 3};
+  List<int>::ListIterator results[5];
+  ASSERT_EQ(list.FindMany(values, results), 4);
+  for (size_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(results[i], list.Find(values[i]));
+  }
+  ASSERT_EQ(results[1], list.End());
+  ASSERT_EQ(list.FindMany(std::span<const int>(), std::span(results)), 0);
+}
+
+TEST_F(ListTest, PrefetchIterator) {
+  auto expected = list.Begin();
+  for (auto it = list.PrefetchBegin(); it != list.End(); ++it) {
+    ASSERT_EQ(it, expected);
+    ASSERT_EQ(*it, *expected++);
+  }
+  auto it = list.PrefetchBegin();
+  it++;
+  list.Erase(it);
+  ASSERT_EQ(list.Size(), sz - 1);
+}
+
+struct Item : IntrusiveListHook<> {
+  int value;
+
+  explicit Item(int v) : value(v) {
+  }
+
+  bool operator==(const Item& other) const {
+    return value == other.value;
+  }
+};
+
+using ItemList = IntrusiveList<Item>;
+
+void ExpectItems(const ItemList& list, std::initializer_list<int> expected) {
+  ASSERT_EQ(list.Size(), expected.size());
+  auto it = list.Begin();
+  for (int value : expected) {
+    ASSERT_EQ(it->value, value);
+    ++it;
+  }
+  ASSERT_EQ(it, list.End());
+}
+
+TEST(IntrusiveListTest, LinkAndIterate) {
+  Item a(1), b(2), c(3);
+  ItemList list;
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_THROW(list.Front(), ListIsEmptyException);
+  ASSERT_THROW(list.PopBack(), ListIsEmptyException);
+  list.PushBack(b);
+  list.PushBack(c);
+  list.PushFront(a);
+  ExpectItems(list, {1, 2, 3});
+  ASSERT_EQ(&list.Front(), &a);
+  ASSERT_EQ(&list.Back(), &c);
+  auto it = list.End();
+  --it;
+  ASSERT_EQ(it->value, 3);
+  it--;
+  ASSERT_EQ((*it).value, 2);
+  ASSERT_EQ(list.Find(Item(3)), list.IteratorTo(c));
+  ASSERT_EQ(list.Find(Item(4)), list.End());
+}
+
+TEST(IntrusiveListTest, UnlinkFromObject) {
+  Item a(1), b(2), c(3);
+  ItemList list;
+  list.PushBack(a);
+  list.PushBack(b);
+  list.PushBack(c);
+  ASSERT_TRUE(b.IsLinked());
+  b.Unlink();
+  ASSERT_FALSE(b.IsLinked());
+  ExpectItems(list, {1, 3});
+  {
+    Item d(4);
+    list.Insert(list.IteratorTo(c), d);
+    ExpectItems(list, {1, 4, 3});
+  }
+  ExpectItems(list, {1, 3});
+  list.PopFront();
+  ASSERT_FALSE(a.IsLinked());
+  ExpectItems(list, {3});
+  list.Clear();
+  ASSERT_FALSE(c.IsLinked());
+  ASSERT_TRUE(list.IsEmpty());
+}
+
+TEST(IntrusiveListTest, InsertMovesLinkedItem) {
+  Item a(1), b(2), c(3);
+  ItemList list;
+  ItemList other;
+  list.PushBack(a);
+  list.PushBack(b);
+  other.PushBack(c);
+  other.PushFront(a);
+  ExpectItems(list, {2});
+  ExpectItems(other, {1, 3});
+  auto it = other.Insert(other.End(), a);
+  ASSERT_EQ(&*it, &a);
+  ExpectItems(other, {3, 1});
+  other.Erase(other.Begin());
+  other.Erase(other.End());
+  ExpectItems(other, {1});
+  ASSERT_FALSE(c.IsLinked());
+}
+
+TEST(IntrusiveListTest, SwapAndMove) {
+  Item a(1), b(2), c(3);
+  ItemList list;
+  ItemList other;
+  list.PushBack(a);
+  list.PushBack(b);
+  other.PushBack(c);
+  std::swap(list, other);
+  ExpectItems(list, {3});
+  ExpectItems(other, {1, 2});
+  ItemList moved(std::move(other));
+  ExpectItems(moved, {1, 2});
+  ASSERT_TRUE(other.IsEmpty());
+  list = std::move(moved);
+  ExpectItems(list, {1, 2});
+  ASSERT_FALSE(c.IsLinked());
+  Item copy = a;
+  ASSERT_FALSE(copy.IsLinked());
+}
+
+struct ByAge {};
+
+struct TaggedItem : IntrusiveListHook<>, IntrusiveListHook<ByAge> {
+  int value;
+
+  explicit TaggedItem(int v) : value(v) {
+  }
+};
+
+TEST(IntrusiveListTest, SizeFollowsUnlinkAfterSwap) {
+  TaggedItem a(1), b(2), c(3);
+  IntrusiveList<TaggedItem> list;
+  IntrusiveList<TaggedItem, ByAge> by_age;
+  IntrusiveList<TaggedItem, ByAge> other;
+  list.PushBack(a);
+  list.PushBack(b);
+  by_age.PushBack(b);
+  by_age.PushBack(a);
+  other.PushBack(c);
+  std::swap(by_age, other);
+  ASSERT_EQ(by_age.Size(), 1);
+  ASSERT_EQ(other.Size(), 2);
+  static_cast<IntrusiveListHook<ByAge>&>(a).Unlink();
+  ASSERT_EQ(other.Size(), 1);
+  ASSERT_EQ(&other.Front(), &b);
+  ASSERT_EQ(list.Size(), 2);
+  {
+    TaggedItem d(4);
+    by_age.PushFront(d);
+    ASSERT_EQ(by_age.Size(), 2);
+  }
+  ASSERT_EQ(by_age.Size(), 1);
+  ASSERT_EQ(&by_age.Front(), &c);
+}
+
+template <typename T>
+void ExpectXorList(const XorList<T>& list, std::initializer_list<T> expected) {
+  ASSERT_EQ(list.Size(), expected.size());
+  auto it = list.Begin();
+  for (const auto& value : expected) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  ASSERT_EQ(it, list.End());
+  for (auto rit = std::rbegin(expected); rit != std::rend(expected); ++rit) {
+    --it;
+    ASSERT_EQ(*it, *rit);
+  }
+  ASSERT_EQ(it, list.Begin());
+}
+
+TEST(XorListTest, PushPopBothEnds) {
+  XorList<int> list;
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(list.Begin(), list.End());
+  ASSERT_THROW(list.Front(), ListIsEmptyException);
+  ASSERT_THROW(list.PopBack(), ListIsEmptyException);
+  list.PushBack(2);
+  list.PushFront(1);
+  list.EmplaceBack(3);
+  ExpectXorList(list, {1, 2, 3});
+  ASSERT_EQ(list.Front(), 1);
+  ASSERT_EQ(list.Back(), 3);
+  list.PopBack();
+  list.PopFront();
+  ExpectXorList(list, {2});
+  list.PopFront();
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_THROW(list.PopFront(), ListIsEmptyException);
+}
+
+TEST(XorListTest, InsertAndErase) {
+  XorList<std::string> list{"a", "c", "e"};
+  auto it = list.Find("c");
+  it = list.Insert(it, "b");
+  ASSERT_EQ(*it, "b");
+  ++it;
+  ++it;
+  it = list.Emplace(it, 1, 'd');
+  ExpectXorList<std::string>(list, {"a", "b", "c", "d", "e"});
+  it = list.Erase(list.Find("c"));
+  ASSERT_EQ(*it, "d");
+  it = list.Erase(it);
+  ASSERT_EQ(*it, "e");
+  it = list.Erase(it);
+  ASSERT_EQ(it, list.End());
+  ASSERT_EQ(list.Erase(list.End()), list.End());
+  list.Insert(list.End(), "z");
+  ExpectXorList<std::string>(list, {"a", "b", "z"});
+  ASSERT_EQ(list.Find("q"), list.End());
+}
+
+TEST(XorListTest, ReverseCopyMove) {
+  XorList<int> list{1, 2, 3, 4};
+  list.Reverse();
+  ExpectXorList(list, {4, 3, 2, 1});
+  list.PushBack(0);
+  XorList<int> copy(list);
+  list.Clear();
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_EQ(list.MemoryUsage(), 0);
+  ExpectXorList(copy, {4, 3, 2, 1, 0});
+  list = copy;
+  XorList<int> moved(std::move(copy));
+  ASSERT_TRUE(copy.IsEmpty());
+  ExpectXorList(moved, {4, 3, 2, 1, 0});
+  copy = std::move(moved);
+  std::swap(copy, list);
+  list.PopFront();
+  ExpectXorList(list, {3, 2, 1, 0});
+  ExpectXorList(copy, {4, 3, 2, 1, 0});
+}
+
+TEST(XorListTest, CompactNodes) {
+  const int size = 1 << 16;
+  XorList<int> list;
+  for (int i = 0; i < size; ++i) {
+    list.PushBack(i);
+  }
+  ASSERT_LT(list.MemoryUsage(), size * 17);
+  size_t memory = list.MemoryUsage();
+  for (auto it = list.Begin(); it != list.End();) {
+    it = list.Erase(it);
+    if (it != list.End()) {
+      ++it;
+    }
+  }
+  ASSERT_EQ(list.Size(), size / 2);
+  for (int i = 0; i < size / 2; ++i) {
+    list.PushFront(i);
+  }
+  ASSERT_EQ(list.MemoryUsage(), memory);
+  int64_t sum = 0;
+  for (auto it = list.Begin(); it != list.End(); ++it) {
+    sum += *it;
+  }
+  ASSERT_EQ(sum, int64_t(size / 2) * (size / 2 - 1) / 2 + int64_t(size / 2) * (size / 2));
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+  LruCache<int, std::string> cache(3);
+  ASSERT_EQ(cache.Get(1), nullptr);
+  cache.Put(1, "one");
+  cache.Put(2, "two");
+  cache.Put(3, "three");
+  ASSERT_EQ(*cache.Get(1), "one");
+  cache.Put(4, "four");
+  ASSERT_EQ(cache.Size(), 3);
+  ASSERT_FALSE(cache.Contains(2));
+  ASSERT_TRUE(cache.Contains(1));
+  ASSERT_EQ(*cache.Peek(3), "three");
+  cache.Put(5, "five");
+  ASSERT_FALSE(cache.Contains(3));
+  ASSERT_EQ(cache.Evictions(), 2);
+  ASSERT_EQ(cache.Hits(), 1);
+  ASSERT_EQ(cache.Misses(), 1);
+  cache.ResetStats();
+  ASSERT_EQ(cache.Get(2), nullptr);
+  ASSERT_EQ(cache.Misses(), 1);
+  ASSERT_EQ(cache.Hits(), 0);
+}
+
+TEST(LruCacheTest, UpdateAndErase) {
+  LruCache<std::string, std::unique_ptr<int>> cache(2);
+  cache.Put("a", std::make_unique<int>(1));
+  cache.Put("b", std::make_unique<int>(2));
+  cache.Put("a", std::make_unique<int>(3));
+  ASSERT_EQ(cache.Size(), 2);
+  cache.Put("c", std::make_unique<int>(4));
+  ASSERT_FALSE(cache.Contains("b"));
+  ASSERT_EQ(**cache.Get("a"), 3);
+  ASSERT_TRUE(cache.Erase("a"));
+  ASSERT_FALSE(cache.Erase("a"));
+  ASSERT_EQ(cache.Size(), 1);
+  cache.Clear();
+  ASSERT_TRUE(cache.IsEmpty());
+  ASSERT_EQ(cache.Weight(), 0);
+}
+
+struct StringBytes {
+  size_t operator()(const std::string& key, const std::string& value) const {
+    return key.size() + value.size();
+  }
+};
+
+TEST(LruCacheTest, ByteBudget) {
+  LruCache<std::string, std::string, StringBytes> cache(10);
+  cache.Put("a", "1234");
+  cache.Put("b", "1234");
+  ASSERT_EQ(cache.Weight(), 10);
+  cache.Put("c", "1");
+  ASSERT_EQ(cache.Weight(), 7);
+  ASSERT_FALSE(cache.Contains("a"));
+  cache.Put("b", "12345678");
+  ASSERT_EQ(cache.Weight(), 9);
+  ASSERT_FALSE(cache.Contains("c"));
+  cache.Put("huge", "12345678901");
+  ASSERT_TRUE(cache.IsEmpty());
+  cache.Put("d", "123");
+  cache.Put("e", "123");
+  cache.SetCapacity(4);
+  ASSERT_EQ(cache.Size(), 1);
+  ASSERT_TRUE(cache.Contains("e"));
+  ASSERT_EQ(cache.Capacity(), 4);
+}
+
+TEST(ConcurrentListTest, SortedUniqueSet) {
+  ConcurrentList<int> list;
+  ASSERT_TRUE(list.IsEmpty());
+  ASSERT_TRUE(list.Insert(5));
+  ASSERT_TRUE(list.Insert(1));
+  ASSERT_TRUE(list.Insert(3));
+  ASSERT_FALSE(list.Insert(3));
+  ASSERT_EQ(list.Size(), 3);
+  ASSERT_TRUE(list.Contains(1));
+  ASSERT_FALSE(list.Contains(2));
+  ASSERT_TRUE(list.Erase(3));
+  ASSERT_FALSE(list.Erase(3));
+  ASSERT_FALSE(list.Contains(3));
+  std::vector<int> values;
+  list.ForEach([&values](int value) { values.push_back(value); });
+  ASSERT_EQ(values, (std::vector<int>{1, 5}));
+
+  ConcurrentList<std::string, std::greater<std::string>> strings;
+  strings.Insert("a");
+  strings.Insert("c");
+  strings.Insert("b");
+  std::string joined;
+  strings.ForEach([&joined](const std::string& value) { joined += value; });
+  ASSERT_EQ(joined, "cba");
+}
+
+TEST(ConcurrentListTest, VisitorUpdatesList) {
+  const int size = 1000;
+  ConcurrentList<int> list;
+  for (int value = 0; value < size; ++value) {
+    list.Insert(value);
+  }
+  // The walk is already past the first node and holds a pointer to the second one
+  // while the visitor erases enough nodes to move the epoch on several times
+  int visited = 0;
+  list.ForEach([&list, &visited, size](int value) {
+    ++visited;
+    if (value == 0) {
+      for (int erased = 1; erased < size; ++erased) {
+        list.Erase(erased);
+      }
+      list.Insert(size);
+    }
+  });
+  ASSERT_LE(visited, 2);
+  ASSERT_EQ(list.Size(), 2);
+}
+
+TEST(ConcurrentListTest, ParallelInsert) {
+  const int threads = 4;
+  const int per_thread = 2000;
+  ConcurrentList<int> list;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&list, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        list.Insert(i * threads + t);
+        list.Insert(i * threads + (t + 1) % threads);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  ASSERT_EQ(list.Size(), threads * per_thread);
+  int expected = 0;
+  list.ForEach([&expected](int value) { ASSERT_EQ(value, expected++); });
+  ASSERT_EQ(expected, threads * per_thread);
+}
+
+TEST(ConcurrentListTest, ParallelInsertEraseContains) {
+  const int writers = 3;
+  const int rounds = 3000;
+  const int keys = 64;
+  ConcurrentList<int> list;
+  for (int key = 0; key < keys; key += 2) {
+    list.Insert(key);
+  }
+  std::atomic<bool> stop = false;
+  std::thread reader([&] {
+    while (!stop.load()) {
+      // Even keys are never erased
+      for (int key = 0; key < keys; key += 2) {
+        ASSERT_TRUE(list.Contains(key));
+      }
+    }
+  });
+  std::vector<std::thread> workers;
+  for (int t = 0; t < writers; ++t) {
+    workers.emplace_back([&list, t] {
+      for (int i = 0; i < rounds; ++i) {
+        int key = (i * writers + t) % keys | 1;
+        list.Insert(key);
+        list.Erase(key);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  stop = true;
+  reader.join();
+  for (int key = 1; key < keys; key += 2) {
+    list.Erase(key);
+  }
+  ASSERT_EQ(list.Size(), keys / 2);
+  int previous = -1;
+  list.ForEach([&previous](int value) {
+    ASSERT_EQ(value % 2, 0);
+    ASSERT_LT(previous, value);
+    previous = value;
+  });
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "exceptions.hpp"
+
+// Doubly linked list that keeps prev ^ next in a single word per node.
+// Nodes are carved from chunks owned by the list, so an int node takes
+// 16 bytes with no per-node allocator header.
+// An iterator holds its predecessor as well, so inserting or erasing next to
+// an iterator invalidates it: use the iterators returned by Insert and Erase
+template <typename T>
+class XorList {
+private:
+    struct Node {
+        std::uintptr_t link_;
+        T data_;
+
+        template <typename... Args>
+        explicit Node(std::uintptr_t link, Args&&... args) : link_(link), data_(std::forward<Args>(args)...) {
+        }
+    };
+
+    // A released slot, threaded into the free list until it is reused
+    struct FreeSlot {
+        FreeSlot* next_;
+    };
+
+    struct Chunk {
+        Chunk* next_;
+    };
+
+public:
+    class XorListIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = T;
+        // NOLINTNEXTLINE
+        using reference_type = value_type&;
+        // NOLINTNEXTLINE
+        using pointer_type = value_type*;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        XorListIterator() : prev_(nullptr), current_(nullptr) {
+        }
+
+        inline bool operator==(const XorListIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        inline bool operator!=(const XorListIterator& other) const {
+            return current_ != other.current_;
+        }
+
+        inline reference_type operator*() const {
+            return current_->data_;
+        }
+
+        inline pointer_type operator->() const {
+            return &current_->data_;
+        }
+
+        XorListIterator& operator++() {
+            Node* next = Neighbour(current_, prev_);
+            prev_ = current_;
+            current_ = next;
+            return *this;
+        }
+
+        XorListIterator operator++(int) {
+            XorListIterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        XorListIterator& operator--() {
+            Node* prev = Neighbour(prev_, current_);
+            current_ = prev_;
+            prev_ = prev;
+            return *this;
+        }
+
+        XorListIterator operator--(int) {
+            XorListIterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        friend class XorList<T>;
+
+    private:
+        Node* prev_;
+        Node* current_;
+
+        XorListIterator(Node* prev, Node* current) : prev_(prev), current_(current) {
+        }
+    };
+
+    XorList() : head_(nullptr), tail_(nullptr), size_(0), chunks_(nullptr), free_(nullptr), memory_(0) {
+    }
+
+    XorList(const std::initializer_list<T>& values) : XorList() {
+        for (const auto& value : values) {
+            PushBack(value);
+        }
+    }
+
+    XorList(const XorList& other) : XorList() {
+        for (auto it = other.Begin(); it != other.End(); ++it) {
+            PushBack(*it);
+        }
+    }
+
+    XorList& operator=(const XorList& other) {
+        if (this != &other) {
+            XorList temp(other);
+            Swap(temp);
+        }
+        return *this;
+    }
+
+    XorList(XorList&& other) noexcept : XorList() {
+        Swap(other);
+    }
+
+    XorList& operator=(XorList&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    XorListIterator Begin() const noexcept {
+        return XorListIterator(nullptr, head_);
+    }
+
+    XorListIterator End() const noexcept {
+        return XorListIterator(tail_, nullptr);
+    }
+
+    inline T& Front() const {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return head_->data_;
+    }
+
+    inline T& Back() const {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("List is empty");
+        }
+        return tail_->data_;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Bytes held in chunks, including free slots
+    inline size_t MemoryUsage() const noexcept {
+        return memory_;
+    }
+
+    // Nodes only point at each other, so swapping the ends is enough
+    void Swap(XorList& other) noexcept {
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(size_, other.size_);
+        std::swap(chunks_, other.chunks_);
+        std::swap(free_, other.free_);
+        std::swap(memory_, other.memory_);
+    }
+
+    void PushFront(const T& value) {
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        return *Emplace(Begin(), std::forward<Args>(args)...);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *Emplace(End(), std::forward<Args>(args)...);
+    }
+
+    void PopFront() {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("Cannot pop from an empty list");
+        }
+        Erase(Begin());
+    }
+
+    void PopBack() {
+        if (IsEmpty()) {
+            throw ListIsEmptyException("Cannot pop from an empty list");
+        }
+        Erase(XorListIterator(Neighbour(tail_, nullptr), tail_));
+    }
+
+    XorListIterator Find(const T& value) const {
+        for (auto it = Begin(); it != End(); ++it) {
+            if (*it == value) {
+                return it;
+            }
+        }
+        return End();
+    }
+
+    // Returns an iterator to the element that followed pos
+    XorListIterator Erase(XorListIterator pos) {
+        Node* node = pos.current_;
+        if (!node) {
+            return End();
+        }
+        Node* prev = pos.prev_;
+        Node* next = Neighbour(node, prev);
+        Relink(prev, node, next);
+        Relink(next, node, prev);
+        if (!prev) {
+            head_ = next;
+        }
+        if (!next) {
+            tail_ = prev;
+        }
+        node->~Node();
+        ReleaseSlot(node);
+        --size_;
+        return XorListIterator(prev, next);
+    }
+
+    XorListIterator Insert(XorListIterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    XorListIterator Insert(XorListIterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Constructs an element before pos and returns an iterator to it
+    template <typename... Args>
+    XorListIterator Emplace(XorListIterator pos, Args&&... args) {
+        Node* prev = pos.prev_;
+        Node* next = pos.current_;
+        void* slot = AcquireSlot();
+        Node* node;
+        try {
+            node = new (slot) Node(Address(prev) ^ Address(next), std::forward<Args>(args)...);
+        } catch (...) {
+            ReleaseSlot(slot);
+            throw;
+        }
+        Relink(prev, next, node);
+        Relink(next, prev, node);
+        if (!prev) {
+            head_ = node;
+        }
+        if (!next) {
+            tail_ = node;
+        }
+        ++size_;
+        return XorListIterator(prev, node);
+    }
+
+    // Traversal direction is only defined by which end is the head
+    void Reverse() noexcept {
+        std::swap(head_, tail_);
+    }
+
+    // Destroys the elements and returns every chunk
+    void Clear() noexcept {
+        Node* prev = nullptr;
+        for (Node* curr = head_; curr;) {
+            Node* next = Neighbour(curr, prev);
+            curr->~Node();
+            prev = curr;
+            curr = next;
+        }
+        while (chunks_) {
+            Chunk* next = chunks_->next_;
+            ::operator delete(chunks_, std::align_val_t(SlotAlign));
+            chunks_ = next;
+        }
+        head_ = tail_ = nullptr;
+        free_ = nullptr;
+        size_ = 0;
+        memory_ = 0;
+    }
+
+    ~XorList() {
+        Clear();
+    }
+
+private:
+    Node* head_;
+    Node* tail_;
+    size_t size_;
+    Chunk* chunks_;
+    FreeSlot* free_;
+    size_t memory_;
+
+    static constexpr size_t MinNodesPerChunk = 16;
+    static constexpr size_t MaxChunkBytes = 64 * 1024;
+    static constexpr size_t SlotBytes = std::max(sizeof(Node), sizeof(FreeSlot));
+    static constexpr size_t SlotAlign = std::max(alignof(Node), alignof(FreeSlot));
+    static constexpr size_t ChunkHeaderBytes = (sizeof(Chunk) + SlotAlign - 1) / SlotAlign * SlotAlign;
+    static constexpr size_t MaxNodesPerChunk =
+        std::max(MinNodesPerChunk, (MaxChunkBytes - ChunkHeaderBytes) / SlotBytes);
+
+    static std::uintptr_t Address(const Node* node) noexcept {
+        return reinterpret_cast<std::uintptr_t>(node);
+    }
+
+    // The node on the other side of `node` from `neighbour`
+    static Node* Neighbour(const Node* node, const Node* neighbour) noexcept {
+        return reinterpret_cast<Node*>(node->link_ ^ Address(neighbour));
+    }
+
+    // Replaces the neighbour `from` of node with `to`
+    static void Relink(Node* node, const Node* from, const Node* to) noexcept {
+        if (node) {
+            node->link_ ^= Address(from) ^ Address(to);
+        }
+    }
+
+    // Chunks grow geometrically, so short lists stay small and long ones make few allocations
+    void* AcquireSlot() {
+        if (!free_) {
+            size_t count = std::min(MaxNodesPerChunk, std::max(MinNodesPerChunk, size_));
+            size_t bytes = ChunkHeaderBytes + count * SlotBytes;
+            auto* chunk = static_cast<Chunk*>(::operator new(bytes, std::align_val_t(SlotAlign)));
+            chunk->next_ = chunks_;
+            chunks_ = chunk;
+            memory_ += bytes;
+            char* slots = reinterpret_cast<char*>(chunk) + ChunkHeaderBytes;
+            // Threaded back to front, so consecutive pushes take consecutive slots
+            for (size_t i = count; i > 0; --i) {
+                ReleaseSlot(slots + (i - 1) * SlotBytes);
+            }
+        }
+        FreeSlot* slot = free_;
+        free_ = slot->next_;
+        return slot;
+    }
+
+    void ReleaseSlot(void* slot) noexcept {
+        free_ = new (slot) FreeSlot{free_};
+    }
+};
+
+namespace std {
+template <typename T>
+// NOLINTNEXTLINE
+void swap(XorList<T>& a, XorList<T>& b) {
+    a.Swap(b);
+}
+}  // namespace std
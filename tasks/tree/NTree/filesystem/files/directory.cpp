@@ -8,7 +8,7 @@ std::string Directory::GetName() const {
         return "/";
     }
 
-    for (const auto& [name, child_ptr] : parent_->childs_.Values()) {
+    for (const auto& [name, child_ptr] : parent_->childs_.Ascending()) {
         if (child_ptr == this) {
             return name;
         }
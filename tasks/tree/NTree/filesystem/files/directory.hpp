@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "../fs.hpp"
@@ -16,8 +17,9 @@ class Directory {
 
 private:
     Directory* parent_;
-    Map<std::string, Directory*> childs_;
-    Map<std::string, File> files_;
+    // std::less<> lets path components be looked up as string views
+    Map<std::string, Directory*, std::less<>> childs_;
+    Map<std::string, File, std::less<>> files_;
 };
 
 }  // end namespace filesystem
\ No newline at end of file
@@ -17,7 +17,7 @@ Fs::Fs() {
 
 Fs::~Fs() {
     std::function<void(Directory*)> destroy = [&](Directory* dir) {
-        for (const auto& [_, child] : dir->childs_.Values()) {
+        for (const auto& [_, child] : dir->childs_.Ascending()) {
             destroy(child);
         }
         delete dir;
@@ -48,10 +48,11 @@ void Fs::ChangeDir(const std::string& path) {
                 target = target->parent_;
             }
         } else {
-            if (!target->childs_.Find(part)) {
-                throw FileNotFoundException("Directory not found: " + part);
+            Directory** child = target->childs_.FindPtr(part);
+            if (!child) {
+                throw FileNotFoundException("Directory not found: " + std::string(part));
             }
-            target = target->childs_[part];
+            target = *child;
         }
     }
 
@@ -76,10 +77,11 @@ void Fs::ListFiles(const std::string& path) const {
                     dir = dir->parent_;
                 }
             } else {
-                if (!dir->childs_.Find(part)) {
-                    throw FileNotFoundException("Directory not found: " + part);
+                Directory** child = dir->childs_.FindPtr(part);
+                if (!child) {
+                    throw FileNotFoundException("Directory not found: " + std::string(part));
                 }
-                dir = dir->childs_[part];
+                dir = *child;
             }
         }
     }
@@ -94,7 +96,7 @@ void Fs::MakeDir(const std::string& path, bool is_create_parents) {
     auto parts = Split(path, "/");
 
     for (size_t i = 0; i < parts.size(); ++i) {
-        const std::string& part = parts[i];
+        std::string_view part = parts[i];
         if (part.empty() || part == ".") {
             continue;
         }
@@ -106,26 +108,27 @@ void Fs::MakeDir(const std::string& path, bool is_create_parents) {
             continue;
         }
 
-        if (dir->childs_.Find(part)) {
-            dir = dir->childs_[part];
+        if (Directory** child = dir->childs_.FindPtr(part)) {
+            dir = *child;
         } else {
             if (!is_create_parents && i != parts.size() - 1) {
-                throw FileNotFoundException("Parent directory not found: " + part);
+                throw FileNotFoundException("Parent directory not found: " + std::string(part));
             }
 
             auto* new_dir = new Directory();
             new_dir->parent_ = dir;
-            dir->childs_.Insert({part, new_dir});
+            dir->childs_.TryEmplace(part, new_dir);
             dir = new_dir;
         }
     }
 }
 
-auto Fs::Split(const std::string& str, const std::string& splitter) const -> std::vector<std::string> {
-    std::vector<std::string> result;
+// The parts point into str, so they are only valid while str is
+auto Fs::Split(std::string_view str, std::string_view splitter) const -> std::vector<std::string_view> {
+    std::vector<std::string_view> result;
     size_t pos = 0;
     size_t end = 0;
-    while ((end = str.find(splitter, pos)) != std::string::npos) {
+    while ((end = str.find(splitter, pos)) != std::string_view::npos) {
         if (end != pos) {
             result.push_back(str.substr(pos, end - pos));
         }
@@ -147,7 +150,7 @@ void Fs::RemoveFile(const std::string& path) {
         return;
     }
 
-    std::string target_name = parts.back();
+    std::string_view target_name = parts.back();
     parts.pop_back();
 
     Directory* dir = (path[0] == '/') ? root_ : current_;
@@ -161,37 +164,25 @@ void Fs::RemoveFile(const std::string& path) {
                 dir = dir->parent_;
             }
         } else {
-            if (!dir->childs_.Find(part)) {
-                throw FileNotFoundException("Directory not found: " + part);
+            Directory** child = dir->childs_.FindPtr(part);
+            if (!child) {
+                throw FileNotFoundException("Directory not found: " + std::string(part));
             }
-            dir = dir->childs_[part];
+            dir = *child;
         }
     }
 
     if (dir->files_.Find(target_name)) {
         dir->files_.Erase(target_name);
-    } else if (dir->childs_.Find(target_name)) {
-        auto* sub = dir->childs_[target_name];
-        std::vector<std::string> subnames;
-        for (const auto& [name, _] : sub->childs_.Values()) {
-            subnames.push_back(name);
-        }
-        for (const auto& child : subnames) {
-            sub->childs_.Erase(child);
-        }
-
-        std::vector<std::string> filenames;
-        for (const auto& [name, _] : sub->files_.Values()) {
-            filenames.push_back(name);
-        }
-        for (const auto& f : filenames) {
-            sub->files_.Erase(f);
-        }
+    } else if (Directory** child = dir->childs_.FindPtr(target_name)) {
+        auto* sub = *child;
+        sub->childs_.Clear();
+        sub->files_.Clear();
 
         dir->childs_.Erase(target_name);
         delete sub;
     } else {
-        throw FileNotFoundException("No file or directory found with name: " + target_name);
+        throw FileNotFoundException("No file or directory found with name: " + std::string(target_name));
     }
 }
 
@@ -205,7 +196,7 @@ void Fs::CreateFile(const std::string& path, bool is_overwrite) {
         return;
     }
 
-    std::string filename = parts.back();
+    std::string_view filename = parts.back();
     parts.pop_back();
 
     Directory* dir = (path[0] == '/') ? root_ : current_;
@@ -220,20 +211,20 @@ void Fs::CreateFile(const std::string& path, bool is_overwrite) {
                 dir = dir->parent_;
             }
         } else {
-            if (!dir->childs_.Find(part)) {
-                throw FileNotFoundException("Directory not found: " + part);
+            Directory** child = dir->childs_.FindPtr(part);
+            if (!child) {
+                throw FileNotFoundException("Directory not found: " + std::string(part));
             }
-            dir = dir->childs_[part];
+            dir = *child;
         }
     }
 
-    if (dir->files_.Find(filename)) {
+    auto [file, inserted] = dir->files_.TryEmplace(filename);
+    if (!inserted) {
         if (!is_overwrite) {
-            throw FileNotFoundException("File already exists: " + filename);
+            throw FileNotFoundException("File already exists: " + std::string(filename));
         }
-        dir->files_[filename] = File();
-    } else {
-        dir->files_.Insert({filename, File()});
+        *file = File();
     }
 }
 
@@ -247,7 +238,7 @@ void Fs::WriteToFile(const std::string& path, bool is_overwrite, std::ostringstr
         return;
     }
 
-    std::string filename = parts.back();
+    std::string_view filename = parts.back();
     parts.pop_back();
 
     Directory* dir = (path[0] == '/') ? root_ : current_;
@@ -261,22 +252,24 @@ void Fs::WriteToFile(const std::string& path, bool is_overwrite, std::ostringstr
                 dir = dir->parent_;
             }
         } else {
-            if (!dir->childs_.Find(part)) {
-                throw FileNotFoundException("Directory not found: " + part);
+            Directory** child = dir->childs_.FindPtr(part);
+            if (!child) {
+                throw FileNotFoundException("Directory not found: " + std::string(part));
             }
-            dir = dir->childs_[part];
+            dir = *child;
         }
     }
 
-    if (!dir->files_.Find(filename)) {
-        throw FileNotFoundException("File not found: " + filename);
+    File* file = dir->files_.FindPtr(filename);
+    if (!file) {
+        throw FileNotFoundException("File not found: " + std::string(filename));
     }
 
     std::string data = stream.str();
     if (is_overwrite) {
-        dir->files_[filename].content_ = data;
+        file->content_ = data;
     } else {
-        dir->files_[filename].content_ += data;
+        file->content_ += data;
     }
 }
 
@@ -290,7 +283,7 @@ void Fs::ShowFileContent(const std::string& path) {
         return;
     }
 
-    std::string filename = parts.back();
+    std::string_view filename = parts.back();
     parts.pop_back();
 
     Directory* dir = (path[0] == '/') ? root_ : current_;
@@ -304,15 +297,16 @@ void Fs::ShowFileContent(const std::string& path) {
                 dir = dir->parent_;
             }
         } else {
-            if (!dir->childs_.Find(part)) {
-                throw FileNotFoundException("Directory not found: " + part);
+            Directory** child = dir->childs_.FindPtr(part);
+            if (!child) {
+                throw FileNotFoundException("Directory not found: " + std::string(part));
             }
-            dir = dir->childs_[part];
+            dir = *child;
         }
     }
 
     if (!dir->files_.Find(filename)) {
-        throw FileNotFoundException("File not found: " + filename);
+        throw FileNotFoundException("File not found: " + std::string(filename));
     }
 }
 
@@ -320,12 +314,12 @@ void Fs::FindFile(const std::string& filename) {
     bool found = false;
 
     std::function<void(Directory*, std::string)> dfs = [&](Directory* dir, std::string path_prefix) {
-        for (const auto& [name, file] : dir->files_.Values()) {
+        for (const auto& [name, file] : dir->files_.Ascending()) {
             if (name == filename) {
                 found = true;
             }
         }
-        for (const auto& [name, child] : dir->childs_.Values()) {
+        for (const auto& [name, child] : dir->childs_.Ascending()) {
             dfs(child, path_prefix + "/" + name);
         }
     };
@@ -333,7 +327,7 @@ void Fs::FindFile(const std::string& filename) {
     dfs(root_, "");
 
     if (!found) {
-        throw filesystem::exceptions::FileNotFoundException("File not found: " + filename);
+        throw filesystem::exceptions::FileNotFoundException("File not found: " + std::string(filename));
         ;
     }
 }
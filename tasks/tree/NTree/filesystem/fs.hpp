@@ -2,6 +2,7 @@
 #pragma once
 
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 #include "./detail/exceptions.hpp"
@@ -26,7 +27,7 @@ public:
     void FindFile(const std::string& filename);
 
 private:
-    std::vector<std::string> Split(const std::string& str, const std::string& splitter) const;
+    std::vector<std::string_view> Split(std::string_view str, std::string_view splitter) const;
 
 private:
     Directory* root_;
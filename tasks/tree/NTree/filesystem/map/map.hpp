@@ -1,180 +1,397 @@
-#pragma once
-
-#include <cstdlib>
-#include <functional>
-#include <utility>
-#include <vector>
-
-template <typename Key, typename Value, typename Compare = std::less<Key>>
-class Map {
-public:
-    // fix
-    Map() : root_(nullptr), tree_size_(0), comp_(Compare()) {
-    }
-
-    Value& operator[](const Key& key) {
-        Node** curr = &root_;
-        while (*curr) {
-            if (comp_(key, (*curr)->key)) {
-                curr = &((*curr)->left);
-            } else if (comp_((*curr)->key, key)) {
-                curr = &((*curr)->right);
-            } else {
-                return (*curr)->value;
-            }
-        }
-
-        *curr = new Node(key, Value());
-        ++tree_size_;
-        return (*curr)->value;
-    }
-
-    inline bool IsEmpty() const noexcept {
-        return tree_size_ == 0;
-    }
-
-    inline size_t Size() const noexcept {
-        return tree_size_;
-    }
-
-    void Swap(Map& other) {
-        std::swap(root_, other.root_);
-        std::swap(tree_size_, other.tree_size_);
-    }
-
-    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const noexcept {
-        std::vector<std::pair<const Key, Value>> result;
-        InOrder(root_, result, is_increase);
-        return result;
-    }
-
-    void Insert(const std::pair<const Key, Value>& val) {
-        Node** curr = &root_;
-        while (*curr) {
-            if (comp_(val.first, (*curr)->key)) {
-                curr = &((*curr)->left);
-            } else if (comp_((*curr)->key, val.first)) {
-                curr = &((*curr)->right);
-            } else {
-                (*curr)->value = val.second;
-                return;
-            }
-        }
-        *curr = new Node(val.first, val.second);
-        ++tree_size_;
-    }
-
-    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
-        for (const auto& val : values) {
-            Insert(val);
-        }
-    }
-
-    void Erase(const Key& key) {
-        root_ = EraseNode(root_, key);
-    }
-
-    void Clear() noexcept {
-        ClearTree(root_);
-        root_ = nullptr;
-        tree_size_ = 0;
-    }
-
-    bool Find(const Key& key) const {
-        Node* curr = root_;
-        while (curr) {
-            if (comp_(key, curr->key)) {
-                curr = curr->left;
-            } else if (comp_(curr->key, key)) {
-                curr = curr->right;
-            } else {
-                return true;
-            }
-        }
-        return false;
-    }
-
-    ~Map() {
-        Clear();
-    }
-
-private:
-    struct Node {
-        Key key;
-        Value value;
-        Node* left;
-        Node* right;
-
-        Node(const Key& k, const Value& v) : key(k), value(v), left(nullptr), right(nullptr) {
-        }
-    };
-
-    Node* root_;
-    size_t tree_size_;
-    Compare comp_;
-
-    void InOrder(Node* node, std::vector<std::pair<const Key, Value>>& result, bool is_increase) const {
-        if (!node) {
-            return;
-        }
-        if (is_increase) {
-            InOrder(node->left, result, is_increase);
-            result.emplace_back(node->key, node->value);
-            InOrder(node->right, result, is_increase);
-        } else {
-            InOrder(node->right, result, is_increase);
-            result.emplace_back(node->key, node->value);
-            InOrder(node->left, result, is_increase);
-        }
-    }
-
-    void ClearTree(Node* node) {
-        if (!node) {
-            return;
-        }
-        ClearTree(node->left);
-        ClearTree(node->right);
-        delete node;
-    }
-
-    Node* EraseNode(Node* node, const Key& key) {
-        if (!node) {
-            return nullptr;
-        }
-
-        if (comp_(key, node->key)) {
-            node->left = EraseNode(node->left, key);
-        } else if (comp_(node->key, key)) {
-            node->right = EraseNode(node->right, key);
-        } else {
-            if (!node->left) {
-                Node* temp = node->right;
-                delete node;
-                --tree_size_;
-                return temp;
-            } else if (!node->right) {
-                Node* temp = node->left;
-                delete node;
-                --tree_size_;
-                return temp;
-            } else {
-                Node* min_node = node->right;
-                while (min_node->left) {
-                    min_node = min_node->left;
-                }
-                node->key = min_node->key;
-                node->value = min_node->value;
-                node->right = EraseNode(node->right, min_node->key);
-            }
-        }
-        return node;
-    }
-};
-
-namespace std {
-template <typename Key, typename Value>
-// NOLINTNEXTLINE
-void swap(Map<Key, Value>& a, Map<Key, Value>& b) {
-    a.Swap(b);
-}
-}  // namespace std
+#pragma once
+
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class Map {
+    struct Node;
+
+    static constexpr bool IsTransparent = requires { typename Compare::is_transparent; };
+
+public:
+    // In-order walk that keeps the unvisited ancestors on an explicit stack.
+    // The tree is not balanced, so only stacks deeper than InlineDepth allocate.
+    // The IsConst walk hands out values by const reference
+    template <bool IsConst>
+    class BasicOrderedIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key&, std::conditional_t<IsConst, const Value&, Value&>>;
+        // NOLINTNEXTLINE
+        using reference_type = value_type;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::forward_iterator_tag;
+
+        BasicOrderedIterator() : depth_(0), ascending_(true) {
+        }
+
+        inline bool operator==(const BasicOrderedIterator& other) const {
+            if (depth_ == 0 || other.depth_ == 0) {
+                return depth_ == other.depth_;
+            }
+            return Top() == other.Top();
+        }
+
+        inline bool operator!=(const BasicOrderedIterator& other) const {
+            return !(*this == other);
+        }
+
+        inline reference_type operator*() const {
+            Node* node = Top();
+            return {node->key, node->value};
+        }
+
+        BasicOrderedIterator& operator++() {
+            Node* node = Top();
+            --depth_;
+            if (depth_ >= InlineDepth) {
+                overflow_.pop_back();
+            }
+            PushSpine(ascending_ ? node->right : node->left);
+            return *this;
+        }
+
+        BasicOrderedIterator operator++(int) {
+            BasicOrderedIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+    private:
+        friend class Map;
+
+        static constexpr size_t InlineDepth = 64;
+
+        Node* stack_[InlineDepth];
+        std::vector<Node*> overflow_;
+        size_t depth_;
+        bool ascending_;
+
+        BasicOrderedIterator(Node* root, bool ascending) : depth_(0), ascending_(ascending) {
+            PushSpine(root);
+        }
+
+        Node* Top() const noexcept {
+            return depth_ > InlineDepth ? overflow_.back() : stack_[depth_ - 1];
+        }
+
+        void PushSpine(Node* node) {
+            while (node) {
+                if (depth_ < InlineDepth) {
+                    stack_[depth_] = node;
+                } else {
+                    overflow_.push_back(node);
+                }
+                ++depth_;
+                node = ascending_ ? node->left : node->right;
+            }
+        }
+    };
+
+    using OrderedIterator = BasicOrderedIterator<false>;
+    using ConstOrderedIterator = BasicOrderedIterator<true>;
+
+    // Lazy view for range-based for loops, entries are visited in place
+    template <bool IsConst>
+    class BasicOrderedView {
+    public:
+        // NOLINTNEXTLINE
+        BasicOrderedIterator<IsConst> begin() const {
+            return BasicOrderedIterator<IsConst>(root_, ascending_);
+        }
+
+        // NOLINTNEXTLINE
+        BasicOrderedIterator<IsConst> end() const {
+            return BasicOrderedIterator<IsConst>();
+        }
+
+    private:
+        friend class Map;
+
+        Node* root_;
+        bool ascending_;
+
+        BasicOrderedView(Node* root, bool ascending) : root_(root), ascending_(ascending) {
+        }
+    };
+
+    using OrderedView = BasicOrderedView<false>;
+    using ConstOrderedView = BasicOrderedView<true>;
+
+    // fix
+    Map() : root_(nullptr), tree_size_(0), comp_(Compare()) {
+    }
+
+    Value& operator[](const Key& key) {
+        return *FindOrInsert(key).first;
+    }
+
+    // With a transparent comparator such as std::less<> lookups take anything comparable
+    // with Key, e.g. a std::string_view for std::string keys, without building a Key
+    template <typename K>
+        requires IsTransparent
+    Value& operator[](const K& key) {
+        return *FindOrInsert(key).first;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return tree_size_ == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return tree_size_;
+    }
+
+    void Swap(Map& other) {
+        std::swap(root_, other.root_);
+        std::swap(tree_size_, other.tree_size_);
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const noexcept {
+        std::vector<std::pair<const Key, Value>> result;
+        result.reserve(tree_size_);
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
+        return result;
+    }
+
+    OrderedView Ascending() noexcept {
+        return OrderedView(root_, true);
+    }
+
+    ConstOrderedView Ascending() const noexcept {
+        return ConstOrderedView(root_, true);
+    }
+
+    OrderedView Descending() noexcept {
+        return OrderedView(root_, false);
+    }
+
+    ConstOrderedView Descending() const noexcept {
+        return ConstOrderedView(root_, false);
+    }
+
+    // Calls visitor(key, value) for every entry in order without copying them,
+    // the value is mutable unless the map is const
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) {
+        for (auto [key, value] : OrderedView(root_, is_increase)) {
+            visitor(key, value);
+        }
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        for (auto [key, value] : ConstOrderedView(root_, is_increase)) {
+            visitor(key, value);
+        }
+    }
+
+    void Insert(const std::pair<const Key, Value>& val) {
+        Node** curr = &root_;
+        while (*curr) {
+            if (comp_(val.first, (*curr)->key)) {
+                curr = &((*curr)->left);
+            } else if (comp_((*curr)->key, val.first)) {
+                curr = &((*curr)->right);
+            } else {
+                (*curr)->value = val.second;
+                return;
+            }
+        }
+        *curr = new Node(val.first, val.second);
+        ++tree_size_;
+    }
+
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& val : values) {
+            Insert(val);
+        }
+    }
+
+    void Erase(const Key& key) {
+        root_ = EraseNode(root_, key);
+    }
+
+    template <typename K>
+        requires IsTransparent
+    void Erase(const K& key) {
+        root_ = EraseNode(root_, key);
+    }
+
+    void Clear() noexcept {
+        ClearTree(root_);
+        root_ = nullptr;
+        tree_size_ = 0;
+    }
+
+    bool Find(const Key& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    bool Find(const K& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    // The value for key or nullptr, in a single descent
+    Value* FindPtr(const Key& key) {
+        Node* node = FindNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    const Value* FindPtr(const Key& key) const {
+        Node* node = FindNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    Value* FindPtr(const K& key) {
+        Node* node = FindNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    const Value* FindPtr(const K& key) const {
+        Node* node = FindNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    // Constructs the value from args only if key is absent. Returns the value
+    // for key and whether it was inserted
+    template <typename... Args>
+    std::pair<Value*, bool> TryEmplace(const Key& key, Args&&... args) {
+        return FindOrInsert(key, std::forward<Args>(args)...);
+    }
+
+    template <typename K, typename... Args>
+        requires IsTransparent
+    std::pair<Value*, bool> TryEmplace(const K& key, Args&&... args) {
+        return FindOrInsert(key, std::forward<Args>(args)...);
+    }
+
+    // Returns true if key was inserted, false if its value was replaced
+    template <typename V>
+    bool InsertOrAssign(const Key& key, V&& value) {
+        auto [slot, inserted] = FindOrInsert(key, std::forward<V>(value));
+        if (!inserted) {
+            *slot = std::forward<V>(value);
+        }
+        return inserted;
+    }
+
+    ~Map() {
+        Clear();
+    }
+
+private:
+    struct Node {
+        Key key;
+        Value value;
+        Node* left;
+        Node* right;
+
+        template <typename K, typename... Args>
+        explicit Node(const K& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...), left(nullptr), right(nullptr) {
+        }
+    };
+
+    Node* root_;
+    size_t tree_size_;
+    Compare comp_;
+
+    void ClearTree(Node* node) {
+        if (!node) {
+            return;
+        }
+        ClearTree(node->left);
+        ClearTree(node->right);
+        delete node;
+    }
+
+    template <typename K>
+    Node* FindNode(const K& key) const {
+        Node* curr = root_;
+        while (curr) {
+            if (comp_(key, curr->key)) {
+                curr = curr->left;
+            } else if (comp_(curr->key, key)) {
+                curr = curr->right;
+            } else {
+                return curr;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the value for key and whether it was just constructed from args
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> FindOrInsert(const K& key, Args&&... args) {
+        Node** curr = &root_;
+        while (*curr) {
+            if (comp_(key, (*curr)->key)) {
+                curr = &((*curr)->left);
+            } else if (comp_((*curr)->key, key)) {
+                curr = &((*curr)->right);
+            } else {
+                return {&(*curr)->value, false};
+            }
+        }
+
+        *curr = new Node(key, std::forward<Args>(args)...);
+        ++tree_size_;
+        return {&(*curr)->value, true};
+    }
+
+    template <typename K>
+    Node* EraseNode(Node* node, const K& key) {
+        if (!node) {
+            return nullptr;
+        }
+
+        if (comp_(key, node->key)) {
+            node->left = EraseNode(node->left, key);
+        } else if (comp_(node->key, key)) {
+            node->right = EraseNode(node->right, key);
+        } else {
+            if (!node->left) {
+                Node* temp = node->right;
+                delete node;
+                --tree_size_;
+                return temp;
+            } else if (!node->right) {
+                Node* temp = node->left;
+                delete node;
+                --tree_size_;
+                return temp;
+            } else {
+                Node* min_node = node->right;
+                while (min_node->left) {
+                    min_node = min_node->left;
+                }
+                node->key = min_node->key;
+                node->value = min_node->value;
+                node->right = EraseNode(node->right, min_node->key);
+            }
+        }
+        return node;
+    }
+};
+
+namespace std {
+template <typename Key, typename Value, typename Compare>
+// NOLINTNEXTLINE
+void swap(Map<Key, Value, Compare>& a, Map<Key, Value, Compare>& b) {
+    a.Swap(b);
+}
+}  // namespace std
@@ -0,0 +1,761 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "map.hpp"
+
+// Byte strings whose lexicographic order is the key order
+template <typename Key>
+struct ArtKeyTraits;
+
+// Big endian with the sign bit flipped, so negative numbers come first
+template <std::integral Key>
+struct ArtKeyTraits<Key> {
+    using LookupKey = Key;
+
+    static std::array<uint8_t, sizeof(Key)> Encode(Key key) noexcept {
+        using Bits = std::make_unsigned_t<Key>;
+        auto bits = static_cast<Bits>(key);
+        if constexpr (std::is_signed_v<Key>) {
+            bits ^= Bits(1) << (sizeof(Key) * CHAR_BIT - 1);
+        }
+        std::array<uint8_t, sizeof(Key)> bytes;
+        for (size_t i = 0; i < sizeof(Key); ++i) {
+            bytes[i] = static_cast<uint8_t>(bits >> ((sizeof(Key) - 1 - i) * CHAR_BIT));
+        }
+        return bytes;
+    }
+};
+
+// Strings compare by unsigned bytes, as std::string does. Lookups take views
+template <>
+struct ArtKeyTraits<std::string> {
+    using LookupKey = std::string_view;
+
+    static std::string_view Encode(std::string_view key) noexcept {
+        return key;
+    }
+};
+
+// Adaptive radix tree. Keys are split into bytes and every inner node branches on
+// one byte, so a lookup costs one step per distinct byte instead of comparisons of
+// whole keys. Inner nodes grow and shrink between 4, 16, 48 and 256 children, and
+// keep the bytes shared by their whole subtree as a compressed prefix. A subtree
+// with a single key is just its leaf, checked against the full key on arrival.
+// A key that ends at an inner node, a prefix of longer keys, is its value leaf
+template <typename Key, typename Value, typename Traits = ArtKeyTraits<Key>>
+class ArtMap {
+private:
+    using LookupKey = typename Traits::LookupKey;
+
+public:
+    ArtMap() : root_(0), size_(0) {
+    }
+
+    ArtMap(ArtMap&& other) noexcept : root_(other.root_), size_(other.size_) {
+        other.root_ = 0;
+        other.size_ = 0;
+    }
+
+    ArtMap& operator=(ArtMap&& other) noexcept {
+        ArtMap tmp(std::move(other));
+        Swap(tmp);
+        return *this;
+    }
+
+    Value& operator[](const Key& key) {
+        return *TryEmplace(key).first;
+    }
+
+    void Insert(const std::pair<const Key, Value>& val) {
+        InsertOrAssign(val.first, val.second);
+    }
+
+    bool Find(LookupKey key) const {
+        return FindLeaf(key) != nullptr;
+    }
+
+    Value* FindPtr(LookupKey key) {
+        Leaf* leaf = FindLeaf(key);
+        return leaf != nullptr ? &leaf->data_.second : nullptr;
+    }
+
+    const Value* FindPtr(LookupKey key) const {
+        Leaf* leaf = FindLeaf(key);
+        return leaf != nullptr ? &leaf->data_.second : nullptr;
+    }
+
+    // Constructs the value from args only if key is absent. Returns the value
+    // for key and whether it was inserted
+    template <typename... Args>
+    std::pair<Value*, bool> TryEmplace(const Key& key, Args&&... args) {
+        auto [leaf, inserted] = FindOrEmplace(key, std::forward<Args>(args)...);
+        return {&leaf->data_.second, inserted};
+    }
+
+    // Returns true if key was inserted, false if its value was replaced
+    template <typename V>
+    bool InsertOrAssign(const Key& key, V&& value) {
+        auto [leaf, inserted] = FindOrEmplace(key, std::forward<V>(value));
+        if (!inserted) {
+            leaf->data_.second = std::forward<V>(value);
+        }
+        return inserted;
+    }
+
+    void Erase(LookupKey key) {
+        if (!EraseFrom(root_, Traits::Encode(key), 0)) {
+            throw MapIsEmptyException("Value not found");
+        }
+    }
+
+    // Calls visitor(key, value) for every entry in order, the value is mutable unless the map is const
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) {
+        Walk(root_, visitor, is_increase);
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        auto read_only = [&visitor](const Key& key, Value& value) { visitor(key, std::as_const(value)); };
+        Walk(root_, read_only, is_increase);
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> result;
+        result.reserve(size_);
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
+        return result;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    void Clear() noexcept {
+        Destroy(root_);
+        root_ = 0;
+        size_ = 0;
+    }
+
+    void Swap(ArtMap& other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(size_, other.size_);
+    }
+
+    ~ArtMap() {
+        Clear();
+    }
+
+private:
+    // A child is a tagged pointer: a Leaf if the low bit is set, a Node otherwise, 0 if empty
+    using Child = std::uintptr_t;
+
+    static constexpr Child LeafBit = 1;
+    static constexpr size_t Node4Capacity = 4;
+    static constexpr size_t Node16Capacity = 16;
+    static constexpr size_t Node48Capacity = 48;
+    static constexpr size_t Node256Capacity = 256;
+    // Shrink thresholds leave some slack, so a node at the border does not flip back and forth
+    static constexpr size_t Node16Shrink = 3;
+    static constexpr size_t Node48Shrink = 12;
+    static constexpr size_t Node256Shrink = 37;
+
+    struct Leaf {
+        std::pair<const Key, Value> data_;
+
+        template <typename... Args>
+        explicit Leaf(const Key& key, Args&&... args)
+            : data_(std::piecewise_construct, std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...)) {
+        }
+    };
+
+    enum class NodeType : uint8_t { Node4, Node16, Node48, Node256 };
+
+    struct Node {
+        NodeType type_;
+        uint16_t count_;
+        // Bytes shared by every key below, skipped before branching
+        std::string prefix_;
+        // The key that ends right after the prefix
+        Leaf* value_;
+
+        explicit Node(NodeType type) : type_(type), count_(0), value_(nullptr) {
+        }
+    };
+
+    // Keys sorted, children at the same positions
+    struct Node4 : Node {
+        uint8_t keys_[Node4Capacity] = {};
+        Child children_[Node4Capacity] = {};
+
+        Node4() : Node(NodeType::Node4) {
+        }
+    };
+
+    struct Node16 : Node {
+        uint8_t keys_[Node16Capacity] = {};
+        Child children_[Node16Capacity] = {};
+
+        Node16() : Node(NodeType::Node16) {
+        }
+    };
+
+    // index_[byte] is the position of the child plus one, 0 if there is none
+    struct Node48 : Node {
+        uint8_t index_[Node256Capacity] = {};
+        Child children_[Node48Capacity] = {};
+
+        Node48() : Node(NodeType::Node48) {
+        }
+    };
+
+    struct Node256 : Node {
+        Child children_[Node256Capacity] = {};
+
+        Node256() : Node(NodeType::Node256) {
+        }
+    };
+
+    Child root_;
+    size_t size_;
+
+    static bool IsLeaf(Child child) noexcept {
+        return (child & LeafBit) != 0;
+    }
+
+    static Leaf* AsLeaf(Child child) noexcept {
+        return reinterpret_cast<Leaf*>(child & ~LeafBit);
+    }
+
+    static Node* AsNode(Child child) noexcept {
+        return reinterpret_cast<Node*>(child);
+    }
+
+    static Child FromLeaf(Leaf* leaf) noexcept {
+        return reinterpret_cast<Child>(leaf) | LeafBit;
+    }
+
+    static Child FromNode(Node* node) noexcept {
+        return reinterpret_cast<Child>(node);
+    }
+
+    template <typename Bytes>
+    static uint8_t ByteAt(const Bytes& bytes, size_t index) noexcept {
+        return static_cast<uint8_t>(bytes[index]);
+    }
+
+    template <typename Bytes>
+    static bool LeafMatches(const Leaf* leaf, const Bytes& bytes) {
+        auto stored = Traits::Encode(leaf->data_.first);
+        return stored.size() == bytes.size() && std::equal(stored.begin(), stored.end(), bytes.begin());
+    }
+
+    // Number of prefix bytes of node that match bytes from depth on
+    template <typename Bytes>
+    static size_t MatchPrefix(const Node* node, const Bytes& bytes, size_t depth) noexcept {
+        size_t limit = std::min(node->prefix_.size(), bytes.size() - depth);
+        size_t matched = 0;
+        while (matched < limit && static_cast<uint8_t>(node->prefix_[matched]) == ByteAt(bytes, depth + matched)) {
+            ++matched;
+        }
+        return matched;
+    }
+
+    static Child* FindChild(Node* node, uint8_t byte) noexcept {
+        switch (node->type_) {
+            case NodeType::Node4: {
+                auto* small = static_cast<Node4*>(node);
+                for (size_t i = 0; i < small->count_; ++i) {
+                    if (small->keys_[i] == byte) {
+                        return &small->children_[i];
+                    }
+                }
+                return nullptr;
+            }
+            case NodeType::Node16: {
+                auto* medium = static_cast<Node16*>(node);
+#if defined(__SSE2__)
+                // All 16 keys are compared at once, the mask drops the unused slots
+                __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(medium->keys_));
+                __m128i equal = _mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(byte)));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(equal)) & ((1U << medium->count_) - 1);
+                return mask != 0 ? &medium->children_[std::countr_zero(mask)] : nullptr;
+#else
+                for (size_t i = 0; i < medium->count_; ++i) {
+                    if (medium->keys_[i] == byte) {
+                        return &medium->children_[i];
+                    }
+                }
+                return nullptr;
+#endif
+            }
+            case NodeType::Node48: {
+                auto* large = static_cast<Node48*>(node);
+                return large->index_[byte] != 0 ? &large->children_[large->index_[byte] - 1] : nullptr;
+            }
+            case NodeType::Node256: {
+                auto* full = static_cast<Node256*>(node);
+                return full->children_[byte] != 0 ? &full->children_[byte] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    // Inserts into sorted keys and children of a node with room left
+    template <typename SortedNode>
+    static void InsertSorted(SortedNode* node, uint8_t byte, Child child) noexcept {
+        size_t pos = node->count_;
+        while (pos > 0 && node->keys_[pos - 1] > byte) {
+            node->keys_[pos] = node->keys_[pos - 1];
+            node->children_[pos] = node->children_[pos - 1];
+            --pos;
+        }
+        node->keys_[pos] = byte;
+        node->children_[pos] = child;
+        ++node->count_;
+    }
+
+    template <typename SortedNode>
+    static void EraseSorted(SortedNode* node, uint8_t byte) noexcept {
+        size_t pos = 0;
+        while (node->keys_[pos] != byte) {
+            ++pos;
+        }
+        for (; pos + 1 < node->count_; ++pos) {
+            node->keys_[pos] = node->keys_[pos + 1];
+            node->children_[pos] = node->children_[pos + 1];
+        }
+        node->children_[pos] = 0;
+        --node->count_;
+    }
+
+    static void MoveHeader(Node* from, Node* to) noexcept {
+        to->prefix_ = std::move(from->prefix_);
+        to->value_ = from->value_;
+    }
+
+    // Calls f(byte, child) in byte order, or in reverse
+    template <typename F>
+    static void ForEachChild(const Node* node, F f, bool ascending) {
+        switch (node->type_) {
+            case NodeType::Node4:
+            case NodeType::Node16: {
+                const uint8_t* keys = node->type_ == NodeType::Node4 ? static_cast<const Node4*>(node)->keys_
+                                                                     : static_cast<const Node16*>(node)->keys_;
+                const Child* children = node->type_ == NodeType::Node4
+                                            ? static_cast<const Node4*>(node)->children_
+                                            : static_cast<const Node16*>(node)->children_;
+                for (size_t i = 0; i < node->count_; ++i) {
+                    size_t pos = ascending ? i : node->count_ - 1 - i;
+                    f(keys[pos], children[pos]);
+                }
+                return;
+            }
+            case NodeType::Node48: {
+                const auto* large = static_cast<const Node48*>(node);
+                for (size_t i = 0; i < Node256Capacity; ++i) {
+                    size_t byte = ascending ? i : Node256Capacity - 1 - i;
+                    if (large->index_[byte] != 0) {
+                        f(static_cast<uint8_t>(byte), large->children_[large->index_[byte] - 1]);
+                    }
+                }
+                return;
+            }
+            case NodeType::Node256: {
+                const auto* full = static_cast<const Node256*>(node);
+                for (size_t i = 0; i < Node256Capacity; ++i) {
+                    size_t byte = ascending ? i : Node256Capacity - 1 - i;
+                    if (full->children_[byte] != 0) {
+                        f(static_cast<uint8_t>(byte), full->children_[byte]);
+                    }
+                }
+                return;
+            }
+        }
+    }
+
+    // Moves the children of node into a fresh node of type To, node keeps its prefix and value
+    template <typename To>
+    static To* Resize(Node* node) {
+        auto* resized = new To();
+        ForEachChild(
+            node,
+            [resized](uint8_t byte, Child child) {
+                if constexpr (std::is_same_v<To, Node48>) {
+                    resized->children_[resized->count_] = child;
+                    resized->index_[byte] = static_cast<uint8_t>(++resized->count_);
+                } else if constexpr (std::is_same_v<To, Node256>) {
+                    resized->children_[byte] = child;
+                    ++resized->count_;
+                } else {
+                    InsertSorted(resized, byte, child);
+                }
+            },
+            true);
+        MoveHeader(node, resized);
+        return resized;
+    }
+
+    // Adds a child to node, which ref points to, moving it to a larger node if full
+    static void AddChild(Child& ref, Node* node, uint8_t byte, Child child) {
+        switch (node->type_) {
+            case NodeType::Node4:
+                if (node->count_ < Node4Capacity) {
+                    InsertSorted(static_cast<Node4*>(node), byte, child);
+                    return;
+                }
+                ref = FromNode(Resize<Node16>(node));
+                break;
+            case NodeType::Node16:
+                if (node->count_ < Node16Capacity) {
+                    InsertSorted(static_cast<Node16*>(node), byte, child);
+                    return;
+                }
+                ref = FromNode(Resize<Node48>(node));
+                break;
+            case NodeType::Node48: {
+                auto* large = static_cast<Node48*>(node);
+                if (large->count_ < Node48Capacity) {
+                    // Erased children leave holes, take the first one
+                    size_t pos = 0;
+                    while (large->children_[pos] != 0) {
+                        ++pos;
+                    }
+                    large->children_[pos] = child;
+                    large->index_[byte] = static_cast<uint8_t>(pos + 1);
+                    ++large->count_;
+                    return;
+                }
+                ref = FromNode(Resize<Node256>(node));
+                break;
+            }
+            case NodeType::Node256: {
+                auto* full = static_cast<Node256*>(node);
+                full->children_[byte] = child;
+                ++full->count_;
+                return;
+            }
+        }
+        DeleteNode(node);
+        AddChild(ref, AsNode(ref), byte, child);
+    }
+
+    static void RemoveChild(Node* node, uint8_t byte) noexcept {
+        switch (node->type_) {
+            case NodeType::Node4:
+                EraseSorted(static_cast<Node4*>(node), byte);
+                return;
+            case NodeType::Node16:
+                EraseSorted(static_cast<Node16*>(node), byte);
+                return;
+            case NodeType::Node48: {
+                auto* large = static_cast<Node48*>(node);
+                large->children_[large->index_[byte] - 1] = 0;
+                large->index_[byte] = 0;
+                --large->count_;
+                return;
+            }
+            case NodeType::Node256:
+                static_cast<Node256*>(node)->children_[byte] = 0;
+                --node->count_;
+                return;
+        }
+    }
+
+    // After an erase below node: replaces a node left with a single entry by that entry,
+    // and moves a sparse node to a smaller type
+    static void Shrink(Child& ref, Node* node) {
+        if (node->count_ == 0) {
+            ref = node->value_ != nullptr ? FromLeaf(node->value_) : 0;
+            DeleteNode(node);
+            return;
+        }
+        switch (node->type_) {
+            case NodeType::Node4: {
+                auto* small = static_cast<Node4*>(node);
+                if (small->count_ > 1 || small->value_ != nullptr) {
+                    return;
+                }
+                Child child = small->children_[0];
+                if (!IsLeaf(child)) {
+                    // The only child absorbs the prefix and the branch byte
+                    Node* only = AsNode(child);
+                    std::string prefix = small->prefix_;
+                    prefix.push_back(static_cast<char>(small->keys_[0]));
+                    prefix += only->prefix_;
+                    only->prefix_ = std::move(prefix);
+                }
+                ref = child;
+                break;
+            }
+            case NodeType::Node16:
+                if (node->count_ > Node16Shrink) {
+                    return;
+                }
+                ref = FromNode(Resize<Node4>(node));
+                break;
+            case NodeType::Node48:
+                if (node->count_ > Node48Shrink) {
+                    return;
+                }
+                ref = FromNode(Resize<Node16>(node));
+                break;
+            case NodeType::Node256:
+                if (node->count_ > Node256Shrink) {
+                    return;
+                }
+                ref = FromNode(Resize<Node48>(node));
+                break;
+        }
+        DeleteNode(node);
+    }
+
+    static void DeleteNode(Node* node) noexcept {
+        switch (node->type_) {
+            case NodeType::Node4:
+                delete static_cast<Node4*>(node);
+                return;
+            case NodeType::Node16:
+                delete static_cast<Node16*>(node);
+                return;
+            case NodeType::Node48:
+                delete static_cast<Node48*>(node);
+                return;
+            case NodeType::Node256:
+                delete static_cast<Node256*>(node);
+                return;
+        }
+    }
+
+    static void Destroy(Child child) noexcept {
+        if (child == 0) {
+            return;
+        }
+        if (IsLeaf(child)) {
+            delete AsLeaf(child);
+            return;
+        }
+        Node* node = AsNode(child);
+        ForEachChild(node, [](uint8_t, Child grandchild) { Destroy(grandchild); }, true);
+        delete node->value_;
+        DeleteNode(node);
+    }
+
+    // Places leaf, whose key is bytes, into a new node4 that branches at split
+    template <typename Bytes>
+    static void Place(Node4* node, Leaf* leaf, const Bytes& bytes, size_t split) noexcept {
+        if (bytes.size() == split) {
+            node->value_ = leaf;
+        } else {
+            InsertSorted(node, ByteAt(bytes, split), FromLeaf(leaf));
+        }
+    }
+
+    Leaf* FindLeaf(LookupKey key) const {
+        auto bytes = Traits::Encode(key);
+        Child child = root_;
+        size_t depth = 0;
+        while (child != 0) {
+            if (IsLeaf(child)) {
+                Leaf* leaf = AsLeaf(child);
+                return LeafMatches(leaf, bytes) ? leaf : nullptr;
+            }
+            Node* node = AsNode(child);
+            if (MatchPrefix(node, bytes, depth) != node->prefix_.size()) {
+                return nullptr;
+            }
+            depth += node->prefix_.size();
+            if (depth == bytes.size()) {
+                return node->value_;
+            }
+            Child* next = FindChild(node, ByteAt(bytes, depth));
+            if (next == nullptr) {
+                return nullptr;
+            }
+            child = *next;
+            ++depth;
+        }
+        return nullptr;
+    }
+
+    template <typename... Args>
+    std::pair<Leaf*, bool> FindOrEmplace(const Key& key, Args&&... args) {
+        auto bytes = Traits::Encode(key);
+        Child* ref = &root_;
+        size_t depth = 0;
+        while (*ref != 0 && !IsLeaf(*ref)) {
+            Node* node = AsNode(*ref);
+            size_t matched = MatchPrefix(node, bytes, depth);
+            if (matched < node->prefix_.size()) {
+                // The key leaves the prefix: a new node4 takes the matched part of it
+                Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+                Node4* parent = nullptr;
+                try {
+                    parent = new Node4();
+                    parent->prefix_.assign(node->prefix_, 0, matched);
+                } catch (...) {
+                    delete parent;
+                    delete leaf;
+                    throw;
+                }
+                auto branch = static_cast<uint8_t>(node->prefix_[matched]);
+                node->prefix_.erase(0, matched + 1);
+                InsertSorted(parent, branch, FromNode(node));
+                Place(parent, leaf, bytes, depth + matched);
+                *ref = FromNode(parent);
+                ++size_;
+                return {leaf, true};
+            }
+            depth += matched;
+            if (depth == bytes.size()) {
+                if (node->value_ != nullptr) {
+                    return {node->value_, false};
+                }
+                node->value_ = new Leaf(key, std::forward<Args>(args)...);
+                ++size_;
+                return {node->value_, true};
+            }
+            Child* next = FindChild(node, ByteAt(bytes, depth));
+            if (next == nullptr) {
+                Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+                try {
+                    AddChild(*ref, node, ByteAt(bytes, depth), FromLeaf(leaf));
+                } catch (...) {
+                    delete leaf;
+                    throw;
+                }
+                ++size_;
+                return {leaf, true};
+            }
+            ref = next;
+            ++depth;
+        }
+        if (*ref == 0) {
+            Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+            *ref = FromLeaf(leaf);
+            ++size_;
+            return {leaf, true};
+        }
+        Leaf* existing = AsLeaf(*ref);
+        auto stored = Traits::Encode(existing->data_.first);
+        if (stored.size() == bytes.size() && std::equal(stored.begin(), stored.end(), bytes.begin())) {
+            return {existing, false};
+        }
+        // Two keys share this subtree now: a node4 holds their common bytes and branches after them
+        size_t common = 0;
+        size_t limit = std::min(stored.size(), bytes.size()) - depth;
+        while (common < limit && ByteAt(stored, depth + common) == ByteAt(bytes, depth + common)) {
+            ++common;
+        }
+        Leaf* leaf = new Leaf(key, std::forward<Args>(args)...);
+        Node4* node = nullptr;
+        try {
+            node = new Node4();
+            for (size_t i = 0; i < common; ++i) {
+                node->prefix_.push_back(static_cast<char>(ByteAt(bytes, depth + i)));
+            }
+        } catch (...) {
+            delete node;
+            delete leaf;
+            throw;
+        }
+        Place(node, existing, stored, depth + common);
+        Place(node, leaf, bytes, depth + common);
+        *ref = FromNode(node);
+        ++size_;
+        return {leaf, true};
+    }
+
+    template <typename Bytes>
+    bool EraseFrom(Child& ref, const Bytes& bytes, size_t depth) {
+        if (ref == 0) {
+            return false;
+        }
+        if (IsLeaf(ref)) {
+            Leaf* leaf = AsLeaf(ref);
+            if (!LeafMatches(leaf, bytes)) {
+                return false;
+            }
+            delete leaf;
+            ref = 0;
+            --size_;
+            return true;
+        }
+        Node* node = AsNode(ref);
+        if (MatchPrefix(node, bytes, depth) != node->prefix_.size()) {
+            return false;
+        }
+        depth += node->prefix_.size();
+        if (depth == bytes.size()) {
+            if (node->value_ == nullptr) {
+                return false;
+            }
+            delete node->value_;
+            node->value_ = nullptr;
+            --size_;
+        } else {
+            uint8_t byte = ByteAt(bytes, depth);
+            Child* next = FindChild(node, byte);
+            if (next == nullptr || !EraseFrom(*next, bytes, depth + 1)) {
+                return false;
+            }
+            if (*next == 0) {
+                RemoveChild(node, byte);
+            }
+        }
+        Shrink(ref, node);
+        return true;
+    }
+
+    template <typename Visitor>
+    static void Walk(Child child, Visitor& visitor, bool is_increase) {
+        if (child == 0) {
+            return;
+        }
+        if (IsLeaf(child)) {
+            Leaf* leaf = AsLeaf(child);
+            visitor(leaf->data_.first, leaf->data_.second);
+            return;
+        }
+        // A key ending at the node is a prefix of, so less than, every key below
+        Node* node = AsNode(child);
+        if (is_increase && node->value_ != nullptr) {
+            visitor(node->value_->data_.first, node->value_->data_.second);
+        }
+        ForEachChild(node, [&visitor, is_increase](uint8_t, Child next) { Walk(next, visitor, is_increase); },
+                     is_increase);
+        if (!is_increase && node->value_ != nullptr) {
+            visitor(node->value_->data_.first, node->value_->data_.second);
+        }
+    }
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Traits>
+// NOLINTNEXTLINE
+void swap(ArtMap<Key, Value, Traits>& a, ArtMap<Key, Value, Traits>& b) noexcept {
+    a.Swap(b);
+}
+}  // namespace std
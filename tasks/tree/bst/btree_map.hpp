@@ -0,0 +1,519 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "map.hpp"
+
+// B+tree with the Map interface. Keys and values live only in the leaves,
+// which are chained for in-order scans; inner nodes hold separators.
+// A node fills about NodeBytes, a few cache lines, so a lookup touches
+// one node per level and a tree of a million keys is three to four levels
+// deep. Keys and values must be default constructible
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class BTreeMap {
+private:
+    static constexpr size_t NodeBytes = 512;
+    static constexpr size_t MinKeys = 4;
+    static constexpr size_t LeafKeys = std::max(MinKeys, NodeBytes / (sizeof(Key) + sizeof(Value)));
+    static constexpr size_t InnerKeys = std::max(MinKeys, NodeBytes / (sizeof(Key) + sizeof(void*)));
+
+    struct NodeBase {
+        size_t size_;
+        bool is_leaf_;
+
+        explicit NodeBase(bool is_leaf) : size_(0), is_leaf_(is_leaf) {
+        }
+    };
+
+    // One spare slot on each array lets a node overflow by one entry right before it splits
+    struct Leaf : NodeBase {
+        std::array<Key, LeafKeys + 1> keys_;
+        std::array<Value, LeafKeys + 1> values_;
+        Leaf* prev_;
+        Leaf* next_;
+
+        Leaf() : NodeBase(true), prev_(nullptr), next_(nullptr) {
+        }
+    };
+
+    // Child i holds the keys below keys_[i], child i + 1 the keys from keys_[i] on
+    struct Inner : NodeBase {
+        std::array<Key, InnerKeys + 1> keys_;
+        std::array<NodeBase*, InnerKeys + 2> children_;
+
+        Inner() : NodeBase(false) {
+        }
+    };
+
+    struct PathEntry {
+        Inner* node_;
+        size_t child_;
+    };
+
+    // Every level except the leaves, enough for any 64-bit size with nodes at least half full
+    static constexpr size_t MaxDepth = 64;
+
+    // The nodes that splitting a full leaf creates: a leaf, an inner node for every full
+    // ancestor and a new root if all of them are full. Allocated before the entry goes in,
+    // so a failed allocation leaves the tree unchanged
+    class SplitNodes {
+    public:
+        SplitNodes(const PathEntry* path, size_t depth) : leaf_(std::make_unique<Leaf>()), inner_count_(0) {
+            size_t level = depth;
+            while (level > 0 && path[level - 1].node_->size_ == InnerKeys) {
+                --level;
+            }
+            size_t inners = depth - level + (level == 0 ? 1 : 0);
+            while (inner_count_ < inners) {
+                inners_[inner_count_++] = std::make_unique<Inner>();
+            }
+        }
+
+        Leaf* TakeLeaf() noexcept {
+            return leaf_.release();
+        }
+
+        Inner* TakeInner() noexcept {
+            return inners_[--inner_count_].release();
+        }
+
+    private:
+        std::unique_ptr<Leaf> leaf_;
+        std::unique_ptr<Inner> inners_[MaxDepth + 1];
+        size_t inner_count_;
+    };
+
+public:
+    BTreeMap() : root_(nullptr), tree_size_(0) {
+    }
+
+    explicit BTreeMap(Compare comp) : root_(nullptr), tree_size_(0), comp_(std::move(comp)) {
+    }
+
+    BTreeMap(const BTreeMap&) = delete;
+    BTreeMap& operator=(const BTreeMap&) = delete;
+
+    Value& operator[](const Key& key) {
+        auto [leaf, pos] = FindOrInsert(key);
+        return leaf->values_[pos];
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return tree_size_ == 0;
+    }
+
+    inline size_t Size() const noexcept {
+        return tree_size_;
+    }
+
+    void Swap(BTreeMap& a) noexcept {
+        std::swap(root_, a.root_);
+        std::swap(tree_size_, a.tree_size_);
+        std::swap(comp_, a.comp_);
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> result;
+        result.reserve(tree_size_);
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
+        return result;
+    }
+
+    // Calls visitor(key, value) for every entry in order, walking the leaf chain instead of the tree.
+    // The value is mutable unless the map is const
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) {
+        VisitLeaves(visitor, is_increase);
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        auto read_only = [&visitor](const Key& key, Value& value) { visitor(key, std::as_const(value)); };
+        VisitLeaves(read_only, is_increase);
+    }
+
+    // Entries with lo <= key < hi in increasing order
+    std::vector<std::pair<const Key, Value>> Range(const Key& lo, const Key& hi) const {
+        std::vector<std::pair<const Key, Value>> result;
+        if (root_ == nullptr) {
+            return result;
+        }
+        const Leaf* leaf = FindLeaf(lo);
+        size_t pos = LowerBound(leaf, lo);
+        for (; leaf != nullptr; leaf = leaf->next_, pos = 0) {
+            for (; pos < leaf->size_; ++pos) {
+                if (!comp_(leaf->keys_[pos], hi)) {
+                    return result;
+                }
+                result.emplace_back(leaf->keys_[pos], leaf->values_[pos]);
+            }
+        }
+        return result;
+    }
+
+    void Insert(const std::pair<const Key, Value>& val) {
+        auto [leaf, pos] = FindOrInsert(val.first);
+        leaf->values_[pos] = val.second;
+    }
+
+    void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
+        for (const auto& value : values) {
+            Insert(value);
+        }
+    }
+
+    void Erase(const Key& key) {
+        PathEntry path[MaxDepth];
+        size_t depth = 0;
+        Leaf* leaf = Descend(key, path, depth);
+        size_t pos = leaf == nullptr ? 0 : LowerBound(leaf, key);
+        if (leaf == nullptr || pos == leaf->size_ || comp_(key, leaf->keys_[pos])) {
+            throw MapIsEmptyException("Value not found");
+        }
+        ShiftLeft(leaf->keys_, pos, leaf->size_);
+        ShiftLeft(leaf->values_, pos, leaf->size_);
+        --leaf->size_;
+        --tree_size_;
+        FixUnderflow(leaf, path, depth);
+    }
+
+    void Clear() noexcept {
+        ClearTree(root_);
+        root_ = nullptr;
+        tree_size_ = 0;
+    }
+
+    bool Find(const Key& key) const {
+        if (root_ == nullptr) {
+            return false;
+        }
+        const Leaf* leaf = FindLeaf(key);
+        size_t pos = LowerBound(leaf, key);
+        return pos < leaf->size_ && !comp_(key, leaf->keys_[pos]);
+    }
+
+    ~BTreeMap() {
+        Clear();
+    }
+
+private:
+    NodeBase* root_;
+    size_t tree_size_;
+    Compare comp_;
+
+    static Leaf* AsLeaf(NodeBase* node) noexcept {
+        return static_cast<Leaf*>(node);
+    }
+
+    static Inner* AsInner(NodeBase* node) noexcept {
+        return static_cast<Inner*>(node);
+    }
+
+    template <typename Node>
+    size_t LowerBound(const Node* node, const Key& key) const {
+        return std::lower_bound(node->keys_.begin(), node->keys_.begin() + node->size_, key, comp_) -
+               node->keys_.begin();
+    }
+
+    size_t ChildIndex(const Inner* node, const Key& key) const {
+        return std::upper_bound(node->keys_.begin(), node->keys_.begin() + node->size_, key, comp_) -
+               node->keys_.begin();
+    }
+
+    const Leaf* FindLeaf(const Key& key) const {
+        NodeBase* node = root_;
+        while (!node->is_leaf_) {
+            node = AsInner(node)->children_[ChildIndex(AsInner(node), key)];
+        }
+        return AsLeaf(node);
+    }
+
+    Leaf* EdgeLeaf(bool rightmost) const {
+        if (root_ == nullptr) {
+            return nullptr;
+        }
+        NodeBase* node = root_;
+        while (!node->is_leaf_) {
+            node = AsInner(node)->children_[rightmost ? node->size_ : 0];
+        }
+        return AsLeaf(node);
+    }
+
+    template <typename Visitor>
+    void VisitLeaves(Visitor& visitor, bool is_increase) const {
+        if (is_increase) {
+            for (Leaf* leaf = EdgeLeaf(false); leaf != nullptr; leaf = leaf->next_) {
+                for (size_t i = 0; i < leaf->size_; ++i) {
+                    visitor(std::as_const(leaf->keys_[i]), leaf->values_[i]);
+                }
+            }
+        } else {
+            for (Leaf* leaf = EdgeLeaf(true); leaf != nullptr; leaf = leaf->prev_) {
+                for (size_t i = leaf->size_; i-- > 0;) {
+                    visitor(std::as_const(leaf->keys_[i]), leaf->values_[i]);
+                }
+            }
+        }
+    }
+
+    // Records the inner nodes and child indices on the way to the leaf for key
+    Leaf* Descend(const Key& key, PathEntry* path, size_t& depth) const {
+        if (root_ == nullptr) {
+            return nullptr;
+        }
+        NodeBase* node = root_;
+        while (!node->is_leaf_) {
+            Inner* inner = AsInner(node);
+            size_t child = ChildIndex(inner, key);
+            path[depth++] = {inner, child};
+            node = inner->children_[child];
+        }
+        return AsLeaf(node);
+    }
+
+    template <typename Array>
+    static void ShiftRight(Array& array, size_t from, size_t size) {
+        std::move_backward(array.begin() + from, array.begin() + size, array.begin() + size + 1);
+    }
+
+    template <typename Array>
+    static void ShiftLeft(Array& array, size_t from, size_t size) {
+        std::move(array.begin() + from + 1, array.begin() + size, array.begin() + from);
+    }
+
+    std::pair<Leaf*, size_t> FindOrInsert(const Key& key) {
+        if (root_ == nullptr) {
+            root_ = new Leaf();
+        }
+        PathEntry path[MaxDepth];
+        size_t depth = 0;
+        Leaf* leaf = Descend(key, path, depth);
+        size_t pos = LowerBound(leaf, key);
+        if (pos < leaf->size_ && !comp_(key, leaf->keys_[pos])) {
+            return {leaf, pos};
+        }
+        if (leaf->size_ < LeafKeys) {
+            InsertAt(leaf, pos, key);
+            return {leaf, pos};
+        }
+        SplitNodes nodes(path, depth);
+        InsertAt(leaf, pos, key);
+        return SplitLeaf(leaf, pos, path, depth, nodes);
+    }
+
+    void InsertAt(Leaf* leaf, size_t pos, const Key& key) {
+        ShiftRight(leaf->keys_, pos, leaf->size_);
+        ShiftRight(leaf->values_, pos, leaf->size_);
+        leaf->keys_[pos] = key;
+        leaf->values_[pos] = Value{};
+        ++leaf->size_;
+        ++tree_size_;
+    }
+
+    // Splits an overflowing leaf and returns the new location of the entry at pos.
+    // Appending to the last leaf or prepending to the first one leaves the old
+    // entries in a full leaf, so sorted inserts pack leaves densely
+    std::pair<Leaf*, size_t> SplitLeaf(Leaf* leaf, size_t pos, PathEntry* path, size_t depth, SplitNodes& nodes) {
+        size_t keep = leaf->size_ / 2;
+        if (leaf->next_ == nullptr && pos == LeafKeys) {
+            keep = LeafKeys;
+        } else if (leaf->prev_ == nullptr && pos == 0) {
+            keep = 1;
+        }
+        Leaf* right = nodes.TakeLeaf();
+        right->size_ = leaf->size_ - keep;
+        std::move(leaf->keys_.begin() + keep, leaf->keys_.begin() + leaf->size_, right->keys_.begin());
+        std::move(leaf->values_.begin() + keep, leaf->values_.begin() + leaf->size_, right->values_.begin());
+        leaf->size_ = keep;
+        right->next_ = leaf->next_;
+        right->prev_ = leaf;
+        if (leaf->next_ != nullptr) {
+            leaf->next_->prev_ = right;
+        }
+        leaf->next_ = right;
+        InsertSeparator(right->keys_[0], right, path, depth, nodes);
+        if (pos < keep) {
+            return {leaf, pos};
+        }
+        return {right, pos - keep};
+    }
+
+    // Adds separator and the node right of it to the parent, splitting inner nodes upwards
+    void InsertSeparator(Key separator, NodeBase* right, PathEntry* path, size_t depth, SplitNodes& nodes) {
+        while (depth > 0) {
+            auto [parent, child] = path[--depth];
+            ShiftRight(parent->keys_, child, parent->size_);
+            ShiftRight(parent->children_, child + 1, parent->size_ + 1);
+            parent->keys_[child] = std::move(separator);
+            parent->children_[child + 1] = right;
+            ++parent->size_;
+            if (parent->size_ <= InnerKeys) {
+                return;
+            }
+            size_t mid = parent->size_ / 2;
+            Inner* sibling = nodes.TakeInner();
+            sibling->size_ = parent->size_ - mid - 1;
+            std::move(parent->keys_.begin() + mid + 1, parent->keys_.begin() + parent->size_, sibling->keys_.begin());
+            std::copy(parent->children_.begin() + mid + 1, parent->children_.begin() + parent->size_ + 1,
+                      sibling->children_.begin());
+            separator = std::move(parent->keys_[mid]);
+            parent->size_ = mid;
+            right = sibling;
+        }
+        Inner* root = nodes.TakeInner();
+        root->size_ = 1;
+        root->keys_[0] = std::move(separator);
+        root->children_[0] = root_;
+        root->children_[1] = right;
+        root_ = root;
+    }
+
+    // Refills a node that fell below half capacity from a sibling, or merges it into one
+    void FixUnderflow(Leaf* leaf, PathEntry* path, size_t depth) {
+        if (depth == 0) {
+            if (leaf->size_ == 0) {
+                delete leaf;
+                root_ = nullptr;
+            }
+            return;
+        }
+        if (leaf->size_ >= LeafKeys / 2) {
+            return;
+        }
+        auto [parent, child] = path[depth - 1];
+        if (child > 0) {
+            Leaf* left = AsLeaf(parent->children_[child - 1]);
+            if (left->size_ > LeafKeys / 2) {
+                ShiftRight(leaf->keys_, 0, leaf->size_);
+                ShiftRight(leaf->values_, 0, leaf->size_);
+                leaf->keys_[0] = std::move(left->keys_[left->size_ - 1]);
+                leaf->values_[0] = std::move(left->values_[left->size_ - 1]);
+                --left->size_;
+                ++leaf->size_;
+                parent->keys_[child - 1] = leaf->keys_[0];
+                return;
+            }
+            MergeLeaves(left, leaf);
+            RemoveChild(parent, child, path, depth - 1);
+            return;
+        }
+        Leaf* right = AsLeaf(parent->children_[child + 1]);
+        if (right->size_ > LeafKeys / 2) {
+            leaf->keys_[leaf->size_] = std::move(right->keys_[0]);
+            leaf->values_[leaf->size_] = std::move(right->values_[0]);
+            ShiftLeft(right->keys_, 0, right->size_);
+            ShiftLeft(right->values_, 0, right->size_);
+            --right->size_;
+            ++leaf->size_;
+            parent->keys_[child] = right->keys_[0];
+            return;
+        }
+        MergeLeaves(leaf, right);
+        RemoveChild(parent, child + 1, path, depth - 1);
+    }
+
+    // Moves everything from right into left and frees right
+    static void MergeLeaves(Leaf* left, Leaf* right) {
+        std::move(right->keys_.begin(), right->keys_.begin() + right->size_, left->keys_.begin() + left->size_);
+        std::move(right->values_.begin(), right->values_.begin() + right->size_, left->values_.begin() + left->size_);
+        left->size_ += right->size_;
+        left->next_ = right->next_;
+        if (right->next_ != nullptr) {
+            right->next_->prev_ = left;
+        }
+        delete right;
+    }
+
+    // Drops children_[child] (already merged away) and the separator before it,
+    // then fixes the inner node at path[depth] if it underflows
+    void RemoveChild(Inner* node, size_t child, PathEntry* path, size_t depth) {
+        while (true) {
+            ShiftLeft(node->keys_, child - 1, node->size_);
+            ShiftLeft(node->children_, child, node->size_ + 1);
+            --node->size_;
+            if (depth == 0) {
+                if (node->size_ == 0) {
+                    root_ = node->children_[0];
+                    delete node;
+                }
+                return;
+            }
+            if (node->size_ >= InnerKeys / 2) {
+                return;
+            }
+            auto [parent, index] = path[depth - 1];
+            if (index > 0) {
+                Inner* left = AsInner(parent->children_[index - 1]);
+                if (left->size_ > InnerKeys / 2) {
+                    // Rotate through the parent separator
+                    ShiftRight(node->keys_, 0, node->size_);
+                    ShiftRight(node->children_, 0, node->size_ + 1);
+                    node->keys_[0] = std::move(parent->keys_[index - 1]);
+                    node->children_[0] = left->children_[left->size_];
+                    parent->keys_[index - 1] = std::move(left->keys_[left->size_ - 1]);
+                    --left->size_;
+                    ++node->size_;
+                    return;
+                }
+                MergeInner(left, node, parent->keys_[index - 1]);
+                node = parent;
+                child = index;
+            } else {
+                Inner* right = AsInner(parent->children_[index + 1]);
+                if (right->size_ > InnerKeys / 2) {
+                    node->keys_[node->size_] = std::move(parent->keys_[index]);
+                    node->children_[node->size_ + 1] = right->children_[0];
+                    parent->keys_[index] = std::move(right->keys_[0]);
+                    ShiftLeft(right->keys_, 0, right->size_);
+                    ShiftLeft(right->children_, 0, right->size_ + 1);
+                    --right->size_;
+                    ++node->size_;
+                    return;
+                }
+                MergeInner(node, right, parent->keys_[index]);
+                node = parent;
+                child = index + 1;
+            }
+            --depth;
+        }
+    }
+
+    // Pulls the separator down between left and right and frees right
+    static void MergeInner(Inner* left, Inner* right, Key& separator) {
+        left->keys_[left->size_] = std::move(separator);
+        std::move(right->keys_.begin(), right->keys_.begin() + right->size_, left->keys_.begin() + left->size_ + 1);
+        std::copy(right->children_.begin(), right->children_.begin() + right->size_ + 1,
+                  left->children_.begin() + left->size_ + 1);
+        left->size_ += right->size_ + 1;
+        delete right;
+    }
+
+    static void ClearTree(NodeBase* node) noexcept {
+        if (node == nullptr) {
+            return;
+        }
+        if (node->is_leaf_) {
+            delete AsLeaf(node);
+            return;
+        }
+        Inner* inner = AsInner(node);
+        for (size_t i = 0; i <= inner->size_; ++i) {
+            ClearTree(inner->children_[i]);
+        }
+        delete inner;
+    }
+};
+
+namespace std {
+template <typename Key, typename Value, typename Compare>
+// NOLINTNEXTLINE
+void swap(BTreeMap<Key, Value, Compare>& a, BTreeMap<Key, Value, Compare>& b) {
+    a.Swap(b);
+}
+}  // namespace std
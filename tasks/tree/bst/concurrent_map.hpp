@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "map.hpp"
+
+// Map shared between threads. Keys are spread by hash over independently locked
+// Map shards, so threads working on different shards do not contend. Lookups take
+// the shard lock shared, updates take it exclusively.
+// Ordered iteration locks every shard shared and merges their in-order walks
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Hash = std::hash<Key>>
+class ConcurrentMap {
+private:
+    using ShardMap = Map<Key, Value, Compare>;
+    using ShardIterator = typename ShardMap::ConstOrderedIterator;
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex_;
+        ShardMap map_;
+    };
+
+public:
+    static constexpr size_t DefaultShards = 64;
+
+    // The shard count is rounded up to a power of two
+    explicit ConcurrentMap(size_t shards = DefaultShards, Compare comp = Compare(), Hash hash = Hash())
+        : shard_count_(RoundUp(shards)),
+          shards_(std::make_unique<Shard[]>(shard_count_)),
+          comp_(std::move(comp)),
+          hash_(std::move(hash)) {
+        // The shards order their entries with the same comparator as the merge
+        for (size_t i = 0; i < shard_count_; ++i) {
+            shards_[i].map_ = ShardMap(comp_);
+        }
+    }
+
+    ConcurrentMap(const ConcurrentMap&) = delete;
+    ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+    // Returns false and keeps the old value if key is already present
+    bool Insert(const Key& key, const Value& value) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lock(shard.mutex_);
+        return shard.map_.TryEmplace(key, value).second;
+    }
+
+    // Returns true if key was inserted, false if its value was replaced
+    bool InsertOrAssign(const Key& key, const Value& value) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lock(shard.mutex_);
+        return shard.map_.InsertOrAssign(key, value);
+    }
+
+    bool Erase(const Key& key) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lock(shard.mutex_);
+        return shard.map_.TryErase(key);
+    }
+
+    bool Contains(const Key& key) const {
+        const Shard& shard = ShardFor(key);
+        std::shared_lock lock(shard.mutex_);
+        return shard.map_.Find(key);
+    }
+
+    // A copy of the value, as a reference would outlive the lock
+    std::optional<Value> TryGet(const Key& key) const {
+        const Shard& shard = ShardFor(key);
+        std::shared_lock lock(shard.mutex_);
+        if (const Value* value = shard.map_.FindPtr(key)) {
+            return *value;
+        }
+        return std::nullopt;
+    }
+
+    // Runs updater on the value for key, default constructing it first if absent
+    template <typename Updater>
+    void Update(const Key& key, Updater updater) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lock(shard.mutex_);
+        updater(*shard.map_.TryEmplace(key).first);
+    }
+
+    // Sum over the shards, each read under its own lock
+    size_t Size() const {
+        size_t size = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::shared_lock lock(shards_[i].mutex_);
+            size += shards_[i].map_.Size();
+        }
+        return size;
+    }
+
+    inline bool IsEmpty() const {
+        return Size() == 0;
+    }
+
+    inline size_t ShardCount() const noexcept {
+        return shard_count_;
+    }
+
+    void Clear() {
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::unique_lock lock(shards_[i].mutex_);
+            shards_[i].map_.Clear();
+        }
+    }
+
+    // Calls visitor(key, value) for every entry in key order, the value by const reference.
+    // The shards stay locked shared for the whole walk, so the visitor sees a consistent
+    // snapshot and must not update the map
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        locks.reserve(shard_count_);
+        // Always in index order, so concurrent walks cannot deadlock with each other
+        for (size_t i = 0; i < shard_count_; ++i) {
+            locks.emplace_back(shards_[i].mutex_);
+        }
+
+        std::vector<ShardIterator> heads;
+        heads.reserve(shard_count_);
+        for (size_t i = 0; i < shard_count_; ++i) {
+            const ShardMap& map = shards_[i].map_;
+            auto view = is_increase ? map.Ascending() : map.Descending();
+            if (view.begin() != view.end()) {
+                heads.push_back(view.begin());
+            }
+        }
+
+        // Binary heap of the current head of every non-empty shard, the next entry on top
+        auto before = [&](size_t a, size_t b) {
+            return is_increase ? comp_(heads[a]->first, heads[b]->first) : comp_(heads[b]->first, heads[a]->first);
+        };
+        std::vector<size_t> heap;
+        heap.reserve(heads.size());
+        for (size_t i = 0; i < heads.size(); ++i) {
+            heap.push_back(i);
+            SiftUp(heap, heap.size() - 1, before);
+        }
+        while (!heap.empty()) {
+            size_t top = heap.front();
+            const std::pair<const Key, Value>& entry = *heads[top];
+            visitor(entry.first, entry.second);
+            if (++heads[top] == ShardIterator()) {
+                heap.front() = heap.back();
+                heap.pop_back();
+            }
+            SiftDown(heap, 0, before);
+        }
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> result;
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
+        return result;
+    }
+
+private:
+    // 2^64 divided by the golden ratio
+    static constexpr uint64_t GoldenRatio = 0x9E3779B97F4A7C15ULL;
+    static constexpr unsigned MixShift = 32;
+
+    size_t shard_count_;
+    std::unique_ptr<Shard[]> shards_;
+    Compare comp_;
+    Hash hash_;
+
+    static size_t RoundUp(size_t shards) noexcept {
+        size_t count = 1;
+        while (count < shards) {
+            count *= 2;
+        }
+        return count;
+    }
+
+    // Fibonacci hashing: the high bits of the product mix every bit of the hash,
+    // so identity hashes of sequential keys still spread over the shards
+    size_t ShardIndex(const Key& key) const {
+        uint64_t mixed = static_cast<uint64_t>(hash_(key)) * GoldenRatio;
+        return static_cast<size_t>(mixed >> MixShift) & (shard_count_ - 1);
+    }
+
+    Shard& ShardFor(const Key& key) {
+        return shards_[ShardIndex(key)];
+    }
+
+    const Shard& ShardFor(const Key& key) const {
+        return shards_[ShardIndex(key)];
+    }
+
+    template <typename Before>
+    static void SiftUp(std::vector<size_t>& heap, size_t pos, const Before& before) {
+        while (pos > 0) {
+            size_t parent = (pos - 1) / 2;
+            if (!before(heap[pos], heap[parent])) {
+                return;
+            }
+            std::swap(heap[pos], heap[parent]);
+            pos = parent;
+        }
+    }
+
+    template <typename Before>
+    static void SiftDown(std::vector<size_t>& heap, size_t pos, const Before& before) {
+        while (true) {
+            size_t best = pos;
+            size_t left = 2 * pos + 1;
+            size_t right = left + 1;
+            if (left < heap.size() && before(heap[left], heap[best])) {
+                best = left;
+            }
+            if (right < heap.size() && before(heap[right], heap[best])) {
+                best = right;
+            }
+            if (best == pos) {
+                return;
+            }
+            std::swap(heap[pos], heap[best]);
+            pos = best;
+        }
+    }
+};
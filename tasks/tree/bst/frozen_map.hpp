@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Allocates on cache line boundaries, so element i * (64 / sizeof(T)) starts a line
+template <typename T>
+struct CacheLineAllocator {
+    // NOLINTNEXTLINE
+    using value_type = T;
+
+    static constexpr size_t Align = std::max<size_t>(64, alignof(T));
+
+    CacheLineAllocator() = default;
+
+    template <typename U>
+    // NOLINTNEXTLINE
+    CacheLineAllocator(const CacheLineAllocator<U>&) noexcept {
+    }
+
+    // NOLINTNEXTLINE
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Align)));
+    }
+
+    // NOLINTNEXTLINE
+    void deallocate(T* ptr, size_t) noexcept {
+        ::operator delete(ptr, std::align_val_t(Align));
+    }
+
+    template <typename U>
+    bool operator==(const CacheLineAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+// Immutable map for read-mostly data. The keys form an implicit complete binary
+// search tree stored in BFS (Eytzinger) order: the children of slot k are 2k and
+// 2k + 1, so the top levels share a few cache lines and a lookup descends without
+// chasing pointers. The descent is branchless and prefetches the slots a few levels
+// below. The values live in a parallel array, touched only by a hit
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FrozenMap {
+private:
+    static constexpr bool IsTransparent = requires { typename Compare::is_transparent; };
+
+public:
+    explicit FrozenMap(Compare comp = Compare()) : comp_(std::move(comp)) {
+    }
+
+    // Takes pairs sorted by key, of equal keys the last one wins. size_hint is the
+    // expected number of pairs, so that the staging copy is allocated once
+    template <typename Range>
+    static FrozenMap FromSorted(const Range& range, Compare comp = Compare(), size_t size_hint = 0) {
+        std::vector<std::pair<Key, Value>> entries;
+        entries.reserve(size_hint);
+        for (auto it = std::begin(range); it != std::end(range); ++it) {
+            if (!entries.empty() && !comp(entries.back().first, it->first)) {
+                entries.back() = *it;
+            } else {
+                entries.emplace_back(*it);
+            }
+        }
+        FrozenMap result(std::move(comp));
+        if (entries.empty()) {
+            return result;
+        }
+        // order[k] is the sorted position of the entry in slot k
+        std::vector<size_t> order(entries.size() + 1);
+        size_t next = 0;
+        FillInOrder(order, 1, next);
+        result.keys_.reserve(entries.size() + 1);
+        result.values_.reserve(entries.size());
+        // Slot 0 is never compared, it only keeps slot k at offset k
+        result.keys_.push_back(entries[order[1]].first);
+        for (size_t k = 1; k <= entries.size(); ++k) {
+            result.keys_.push_back(std::move(entries[order[k]].first));
+            result.values_.push_back(std::move(entries[order[k]].second));
+        }
+        return result;
+    }
+
+    bool Find(const Key& key) const {
+        return Slot(key) != 0;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    bool Find(const K& key) const {
+        return Slot(key) != 0;
+    }
+
+    // The value for key or nullptr
+    const Value* FindPtr(const Key& key) const {
+        size_t slot = Slot(key);
+        return slot != 0 ? &values_[slot - 1] : nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    const Value* FindPtr(const K& key) const {
+        size_t slot = Slot(key);
+        return slot != 0 ? &values_[slot - 1] : nullptr;
+    }
+
+    // Calls visitor(key, value) for every entry in order
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        if (!values_.empty()) {
+            Walk(1, visitor, is_increase);
+        }
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> result;
+        result.reserve(values_.size());
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
+        return result;
+    }
+
+    inline size_t Size() const noexcept {
+        return values_.size();
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return values_.empty();
+    }
+
+    void Swap(FrozenMap& other) noexcept {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        std::swap(comp_, other.comp_);
+    }
+
+private:
+    // Slot 16k holds the leftmost descendant of k four levels down for 4-byte keys,
+    // so prefetching it fetches the whole line of those descendants
+    static constexpr size_t PrefetchStride = std::bit_floor(std::max<size_t>(1, 64 / sizeof(Key)));
+
+    std::vector<Key, CacheLineAllocator<Key>> keys_;
+    std::vector<Value> values_;
+    Compare comp_;
+
+    static void FillInOrder(std::vector<size_t>& order, size_t slot, size_t& next) {
+        if (slot >= order.size()) {
+            return;
+        }
+        FillInOrder(order, 2 * slot, next);
+        order[slot] = next++;
+        FillInOrder(order, 2 * slot + 1, next);
+    }
+
+    // The slot of key, 0 if absent
+    template <typename K>
+    size_t Slot(const K& key) const {
+        const Key* keys = keys_.data();
+        size_t size = values_.size();
+        size_t k = 1;
+        while (k <= size) {
+            __builtin_prefetch(keys + std::min(PrefetchStride * k, size));
+            k = 2 * k + static_cast<size_t>(comp_(keys[k], key));
+        }
+        // Every right turn appended a 1 bit, drop them and the last left turn to reach
+        // the first slot not less than key
+        k >>= std::countr_one(k) + 1;
+        return k != 0 && !comp_(key, keys[k]) ? k : 0;
+    }
+
+    template <typename Visitor>
+    void Walk(size_t slot, Visitor& visitor, bool is_increase) const {
+        if (slot > values_.size()) {
+            return;
+        }
+        Walk(is_increase ? 2 * slot : 2 * slot + 1, visitor, is_increase);
+        visitor(keys_[slot], values_[slot - 1]);
+        Walk(is_increase ? 2 * slot + 1 : 2 * slot, visitor, is_increase);
+    }
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Compare>
+// NOLINTNEXTLINE
+void swap(FrozenMap<Key, Value, Compare>& a, FrozenMap<Key, Value, Compare>& b) noexcept {
+    a.Swap(b);
+}
+}  // namespace std
@@ -2,12 +2,20 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <iterator>
+#include <new>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "frozen_map.hpp"
+
 class MapIsEmptyException : public std::exception {
 public:
     explicit MapIsEmptyException(const std::string& text) : error_message_(text) {
@@ -21,34 +29,348 @@ private:
     std::string error_message_;
 };
 
-template <typename Key, typename Value, typename Compare = std::less<Key>>
+// Node storage policies for Map
+
+// Every node is a separate heap allocation
+struct HeapNodeStorage {
+    template <size_t SlotBytes, size_t SlotAlign>
+    class Pool {
+    public:
+        static constexpr bool BulkRelease = false;
+
+        void* Acquire() {
+            return ::operator new(SlotBytes, std::align_val_t(SlotAlign));
+        }
+
+        void Release(void* slot) noexcept {
+            ::operator delete(slot, std::align_val_t(SlotAlign));
+        }
+
+        void Reserve(size_t) {
+        }
+
+        void ReleaseAll() noexcept {
+        }
+
+        void Swap(Pool&) noexcept {
+        }
+
+        void Adopt(Pool&) noexcept {
+        }
+    };
+};
+
+// Nodes are carved from slabs owned by the map and erased nodes are recycled
+// through a free list. Clear returns whole slabs, without visiting the nodes
+// when they are trivially destructible
+struct ArenaNodeStorage {
+    template <size_t SlotBytes, size_t SlotAlign>
+    class Pool {
+    public:
+        static constexpr bool BulkRelease = true;
+
+        Pool() : slabs_(nullptr), free_(nullptr), slots_(0) {
+        }
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        // Slabs grow with the number of slots handed out, up to MaxSlabBytes
+        void* Acquire() {
+            if (!free_) {
+                AddSlab(std::min(MaxSlotsPerSlab, std::max(MinSlotsPerSlab, slots_)));
+            }
+            FreeSlot* slot = free_;
+            free_ = slot->next_;
+            return slot;
+        }
+
+        // Makes the next count acquisitions come from a single slab, in address order
+        void Reserve(size_t count) {
+            if (count > 0) {
+                AddSlab(count);
+            }
+        }
+
+        void Release(void* slot) noexcept {
+            free_ = new (slot) FreeSlot{free_};
+        }
+
+        void ReleaseAll() noexcept {
+            while (slabs_) {
+                Slab* next = slabs_->next_;
+                ::operator delete(slabs_, std::align_val_t(Align));
+                slabs_ = next;
+            }
+            free_ = nullptr;
+            slots_ = 0;
+        }
+
+        void Swap(Pool& other) noexcept {
+            std::swap(slabs_, other.slabs_);
+            std::swap(free_, other.free_);
+            std::swap(slots_, other.slots_);
+        }
+
+        // Takes over the slabs and free slots of other, so nodes acquired from it can be released here
+        void Adopt(Pool& other) noexcept {
+            if (other.slabs_ == nullptr) {
+                return;
+            }
+            Slab* last_slab = other.slabs_;
+            while (last_slab->next_ != nullptr) {
+                last_slab = last_slab->next_;
+            }
+            last_slab->next_ = slabs_;
+            slabs_ = other.slabs_;
+            if (other.free_ != nullptr) {
+                FreeSlot* last_free = other.free_;
+                while (last_free->next_ != nullptr) {
+                    last_free = last_free->next_;
+                }
+                last_free->next_ = free_;
+                free_ = other.free_;
+            }
+            slots_ += other.slots_;
+            other.slabs_ = nullptr;
+            other.free_ = nullptr;
+            other.slots_ = 0;
+        }
+
+        ~Pool() {
+            ReleaseAll();
+        }
+
+    private:
+        struct FreeSlot {
+            FreeSlot* next_;
+        };
+
+        struct Slab {
+            Slab* next_;
+        };
+
+        static constexpr size_t MinSlotsPerSlab = 16;
+        static constexpr size_t MaxSlabBytes = 64 * 1024;
+        static constexpr size_t SlotSize = std::max(SlotBytes, sizeof(FreeSlot));
+        static constexpr size_t Align = std::max(SlotAlign, alignof(FreeSlot));
+        static constexpr size_t SlabHeaderBytes = (sizeof(Slab) + Align - 1) / Align * Align;
+        static constexpr size_t MaxSlotsPerSlab =
+            std::max(MinSlotsPerSlab, (MaxSlabBytes - SlabHeaderBytes) / SlotSize);
+
+        Slab* slabs_;
+        FreeSlot* free_;
+        // Slots in all slabs, used or not
+        size_t slots_;
+
+        void AddSlab(size_t count) {
+            size_t bytes = SlabHeaderBytes + count * SlotSize;
+            auto* slab = static_cast<Slab*>(::operator new(bytes, std::align_val_t(Align)));
+            slab->next_ = slabs_;
+            slabs_ = slab;
+            slots_ += count;
+            char* slots = reinterpret_cast<char*>(slab) + SlabHeaderBytes;
+            // Threaded back to front, so consecutive acquisitions take consecutive slots
+            for (size_t i = count; i > 0; --i) {
+                Release(slots + (i - 1) * SlotSize);
+            }
+        }
+    };
+};
+
+// Stands in for the subtree size in nodes of maps without order statistics
+struct NoSubtreeSize {};
+
+// With OrderStatistics every node also counts the nodes of its subtree, which
+// enables Select, Rank, CountRange and EraseAt in O(log n)
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Storage = HeapNodeStorage,
+          bool OrderStatistics = false>
 class Map {
+    class Node;
+
+    // An AVL tree of height h has at least Fib(h + 2) - 1 nodes, so 64-bit sizes fit in 92 levels
+    static constexpr size_t MaxHeight = 96;
+
+    static constexpr bool IsTransparent = requires { typename Compare::is_transparent; };
+
 public:
+    // In-order walk that keeps the unvisited ancestors on a stack of at most MaxHeight nodes.
+    // The IsConst walk hands out entries by const reference
+    template <bool IsConst>
+    class BasicOrderedIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key, Value>;
+        // NOLINTNEXTLINE
+        using reference_type = std::conditional_t<IsConst, const value_type&, value_type&>;
+        // NOLINTNEXTLINE
+        using pointer_type = std::conditional_t<IsConst, const value_type*, value_type*>;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::forward_iterator_tag;
+
+        BasicOrderedIterator() : depth_(0), ascending_(true) {
+        }
+
+        inline bool operator==(const BasicOrderedIterator& other) const {
+            if (depth_ == 0 || other.depth_ == 0) {
+                return depth_ == other.depth_;
+            }
+            return stack_[depth_ - 1] == other.stack_[other.depth_ - 1];
+        }
+
+        inline bool operator!=(const BasicOrderedIterator& other) const {
+            return !(*this == other);
+        }
+
+        inline reference_type operator*() const {
+            return stack_[depth_ - 1]->data_;
+        }
+
+        inline pointer_type operator->() const {
+            return &stack_[depth_ - 1]->data_;
+        }
+
+        BasicOrderedIterator& operator++() {
+            Node* node = stack_[--depth_];
+            PushSpine(ascending_ ? node->right_ : node->left_);
+            return *this;
+        }
+
+        BasicOrderedIterator operator++(int) {
+            BasicOrderedIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+    private:
+        friend class Map;
+
+        Node* stack_[MaxHeight];
+        size_t depth_;
+        bool ascending_;
+
+        BasicOrderedIterator(Node* root, bool ascending) : depth_(0), ascending_(ascending) {
+            PushSpine(root);
+        }
+
+        void PushSpine(Node* node) noexcept {
+            while (node != nullptr) {
+                stack_[depth_++] = node;
+                node = ascending_ ? node->left_ : node->right_;
+            }
+        }
+    };
+
+    using OrderedIterator = BasicOrderedIterator<false>;
+    using ConstOrderedIterator = BasicOrderedIterator<true>;
+
+    // Lazy view for range-based for loops, entries are visited in place
+    template <bool IsConst>
+    class BasicOrderedView {
+    public:
+        // NOLINTNEXTLINE
+        BasicOrderedIterator<IsConst> begin() const {
+            return BasicOrderedIterator<IsConst>(root_, ascending_);
+        }
+
+        // NOLINTNEXTLINE
+        BasicOrderedIterator<IsConst> end() const {
+            return BasicOrderedIterator<IsConst>();
+        }
+
+    private:
+        friend class Map;
+
+        Node* root_;
+        bool ascending_;
+
+        BasicOrderedView(Node* root, bool ascending) : root_(root), ascending_(ascending) {
+        }
+    };
+
+    using OrderedView = BasicOrderedView<false>;
+    using ConstOrderedView = BasicOrderedView<true>;
+
     Map() {
         root_ = nullptr;
         tree_size_ = 0;
     }
 
-    Value& operator[](const Key& key) {
-        Node** cur = &root_;
-        while (*cur != nullptr) {
-            if (comp_(key, (*cur)->data_.first)) {
-                cur = &((*cur)->left_);
-            } else if (comp_((*cur)->data_.first, key)) {
-                cur = &((*cur)->right_);
-            } else {
-                return (*cur)->data_.second;
-            }
+    explicit Map(Compare comp) : comp_(std::move(comp)) {
+        root_ = nullptr;
+        tree_size_ = 0;
+    }
+
+    Map(Map&& other) noexcept : Map() {
+        Swap(other);
+    }
+
+    Map& operator=(Map&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
         }
+        return *this;
+    }
 
-        *cur = new Node;
-        (*cur)->left_ = nullptr;
-        (*cur)->right_ = nullptr;
+    // Builds a perfectly balanced tree in O(n) from pairs sorted by comp. Of equal keys
+    // the last one wins, as with repeated Insert. With ArenaNodeStorage all nodes come
+    // from one slab, laid out in key order; HeapNodeStorage still allocates every node
+    // separately, since each must be freed on its own when erased
+    template <typename Range>
+    static Map FromSorted(const Range& range, Compare comp = Compare()) {
+        Map result(std::move(comp));
+        size_t count = 0;
+        for (auto it = std::begin(range); it != std::end(range); ++count) {
+            result.SkipEqual(it, std::end(range));
+        }
+        result.pool_.Reserve(count);
+        auto it = std::begin(range);
+        result.root_ = result.BuildBalanced(it, std::end(range), count);
+        result.tree_size_ = count;
+        return result;
+    }
 
-        new (std::addressof((*cur)->data_)) std::pair<const Key, Value>(key, Value{});
+    // Sorts a copy of the pairs with a stable merge sort, then builds the tree like FromSorted
+    template <typename Range>
+    static Map FromUnsorted(const Range& range, Compare comp = Compare()) {
+        std::vector<std::pair<Key, Value>> entries(std::begin(range), std::end(range));
+        std::vector<std::pair<Key, Value>> buffer;
+        buffer.reserve(entries.size());
+        auto less = [&comp](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) {
+            return comp(a.first, b.first);
+        };
+        // Bottom-up passes that merge runs of doubling width into the buffer
+        for (size_t width = 1; width < entries.size(); width *= 2) {
+            buffer.clear();
+            for (size_t lo = 0; lo < entries.size(); lo += 2 * width) {
+                size_t mid = std::min(lo + width, entries.size());
+                size_t hi = std::min(lo + 2 * width, entries.size());
+                size_t i = lo;
+                size_t j = mid;
+                while (i < mid && j < hi) {
+                    buffer.push_back(std::move(less(entries[j], entries[i]) ? entries[j++] : entries[i++]));
+                }
+                std::move(entries.begin() + i, entries.begin() + mid, std::back_inserter(buffer));
+                std::move(entries.begin() + j, entries.begin() + hi, std::back_inserter(buffer));
+            }
+            entries.swap(buffer);
+        }
+        return FromSorted(entries, std::move(comp));
+    }
 
-        ++tree_size_;
-        return (*cur)->data_.second;
+    Value& operator[](const Key& key) {
+        return FindOrEmplace(key).first->data_.second;
+    }
+
+    // With a transparent comparator such as std::less<> lookups take anything comparable
+    // with Key, e.g. a std::string_view for std::string keys, and build a Key only on insertion
+    template <typename K>
+        requires IsTransparent
+    Value& operator[](const K& key) {
+        return FindOrEmplace(key).first->data_.second;
     }
 
     inline bool IsEmpty() const noexcept {
@@ -67,36 +389,59 @@ public:
         size_t tmp_size = tree_size_;
         tree_size_ = a.tree_size_;
         a.tree_size_ = tmp_size;
+
+        std::swap(comp_, a.comp_);
+        pool_.Swap(a.pool_);
     }
 
     std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const noexcept {
         std::vector<std::pair<const Key, Value>> result;
-        Traverse(root_, result, is_increase);
+        result.reserve(tree_size_);
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
         return result;
     }
 
-    void Insert(const std::pair<const Key, Value>& val) {
-        Node** cur = &root_;
-        while (*cur != nullptr) {
-            if (comp_(val.first, (*cur)->data_.first)) {
-                cur = &((*cur)->left_);
-            } else if (comp_((*cur)->data_.first, val.first)) {
-                cur = &((*cur)->right_);
-            } else {
-                (*cur)->data_.second = val.second;
-                return;
-            }
+    // An immutable copy laid out for fast lookups, the entries are copied once
+    FrozenMap<Key, Value, Compare> Freeze() const {
+        return FrozenMap<Key, Value, Compare>::FromSorted(Ascending(), comp_, tree_size_);
+    }
+
+    OrderedView Ascending() noexcept {
+        return OrderedView(root_, true);
+    }
+
+    ConstOrderedView Ascending() const noexcept {
+        return ConstOrderedView(root_, true);
+    }
+
+    OrderedView Descending() noexcept {
+        return OrderedView(root_, false);
+    }
+
+    ConstOrderedView Descending() const noexcept {
+        return ConstOrderedView(root_, false);
+    }
+
+    // Calls visitor(key, value) for every entry in order without copying them,
+    // the value is mutable unless the map is const
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) {
+        for (auto& [key, value] : OrderedView(root_, is_increase)) {
+            visitor(key, value);
         }
-        if (*cur == nullptr) {
-            *cur = new Node;
-            (*cur)->left_ = nullptr;
-            (*cur)->right_ = nullptr;
-            new (std::addressof((*cur)->data_)) std::pair<const Key, Value>(val.first, val.second);
-            ++tree_size_;
-            return;
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        for (const auto& [key, value] : ConstOrderedView(root_, is_increase)) {
+            visitor(key, value);
         }
     }
 
+    void Insert(const std::pair<const Key, Value>& val) {
+        InsertOrAssign(val.first, val.second);
+    }
+
     void Insert(const std::initializer_list<std::pair<const Key, Value>>& values) {
         const std::pair<const Key, Value>* data = values.begin();
         size_t size = values.size();
@@ -106,70 +451,203 @@ public:
     }
 
     void Erase(const Key& key) {
-        Node** parent_ptr = &root_;
-        Node* current = root_;
-        while (current != nullptr) {
-            if (comp_(key, current->data_.first)) {
-                parent_ptr = &current->left_;
-                current = current->left_;
-            } else if (comp_(current->data_.first, key)) {
-                parent_ptr = &current->right_;
-                current = current->right_;
-            } else {
-                break;
-            }
+        if (!EraseKey(key)) {
+            throw MapIsEmptyException("Value not found");
         }
+    }
 
-        if (current == nullptr) {
+    template <typename K>
+        requires IsTransparent
+    void Erase(const K& key) {
+        if (!EraseKey(key)) {
             throw MapIsEmptyException("Value not found");
         }
+    }
 
-        if (current->left_ == nullptr && current->right_ == nullptr) {
-            *parent_ptr = nullptr;
-        } else if (current->left_ == nullptr) {
-            *parent_ptr = current->right_;
-        } else if (current->right_ == nullptr) {
-            *parent_ptr = current->left_;
-        } else {
-            Node** min_parent_ptr = &current->right_;
-            Node* min_node = current->right_;
+    // Like Erase, but a missing key is not an error. Returns whether an entry was removed
+    bool TryErase(const Key& key) {
+        return EraseKey(key);
+    }
 
-            while (min_node->left_ != nullptr) {
-                min_parent_ptr = &min_node->left_;
-                min_node = min_node->left_;
-            }
+    template <typename K>
+        requires IsTransparent
+    bool TryErase(const K& key) {
+        return EraseKey(key);
+    }
 
-            if (min_parent_ptr != &current->right_) {
-                *min_parent_ptr = min_node->right_;
-                min_node->right_ = current->right_;
+    // The entry with k smaller keys
+    std::pair<const Key, Value>& Select(size_t k)
+        requires OrderStatistics
+    {
+        return SelectNode(k)->data_;
+    }
+
+    const std::pair<const Key, Value>& Select(size_t k) const
+        requires OrderStatistics
+    {
+        return SelectNode(k)->data_;
+    }
+
+    // Number of keys less than key
+    size_t Rank(const Key& key) const
+        requires OrderStatistics
+    {
+        size_t rank = 0;
+        Node* node = root_;
+        while (node != nullptr) {
+            if (comp_(node->data_.first, key)) {
+                rank += Count(node->left_) + 1;
+                node = node->right_;
+            } else {
+                node = node->left_;
             }
-            min_node->left_ = current->left_;
-            *parent_ptr = min_node;
         }
+        return rank;
+    }
 
-        current->data_.~pair<const Key, Value>();
-        delete current;
-        --tree_size_;
+    // Number of keys in [lo, hi)
+    size_t CountRange(const Key& lo, const Key& hi) const
+        requires OrderStatistics
+    {
+        if (!comp_(lo, hi)) {
+            return 0;
+        }
+        return Rank(hi) - Rank(lo);
+    }
+
+    void EraseAt(size_t k)
+        requires OrderStatistics
+    {
+        if (k >= tree_size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        Node** path[MaxHeight];
+        size_t depth = 0;
+        Node** link = &root_;
+        while (true) {
+            path[depth++] = link;
+            size_t left = Count((*link)->left_);
+            if (k < left) {
+                link = &(*link)->left_;
+            } else if (k > left) {
+                k -= left + 1;
+                link = &(*link)->right_;
+            } else {
+                break;
+            }
+        }
+        EraseLast(path, depth);
     }
 
     void Clear() noexcept {
-        ClearTree(root_);
+        if constexpr (NodePool::BulkRelease) {
+            if constexpr (!std::is_trivially_destructible_v<Node>) {
+                DestroyTree(root_);
+            }
+            pool_.ReleaseAll();
+        } else {
+            ClearTree(root_);
+        }
         root_ = nullptr;
         tree_size_ = 0;
     }
 
     bool Find(const Key& key) const {
-        Node* cur = root_;
-        while (cur != nullptr) {
-            if (comp_(key, cur->data_.first)) {
-                cur = cur->left_;
-            } else if (comp_(cur->data_.first, key)) {
-                cur = cur->right_;
-            } else {
-                return true;
-            }
+        return FindNode(key) != nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    bool Find(const K& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    // The value for key or nullptr, in a single descent
+    Value* FindPtr(const Key& key) {
+        Node* node = FindNode(key);
+        return node != nullptr ? &node->data_.second : nullptr;
+    }
+
+    const Value* FindPtr(const Key& key) const {
+        Node* node = FindNode(key);
+        return node != nullptr ? &node->data_.second : nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    Value* FindPtr(const K& key) {
+        Node* node = FindNode(key);
+        return node != nullptr ? &node->data_.second : nullptr;
+    }
+
+    template <typename K>
+        requires IsTransparent
+    const Value* FindPtr(const K& key) const {
+        Node* node = FindNode(key);
+        return node != nullptr ? &node->data_.second : nullptr;
+    }
+
+    // Constructs the value from args only if key is absent. Returns the value
+    // for key and whether it was inserted
+    template <typename... Args>
+    std::pair<Value*, bool> TryEmplace(const Key& key, Args&&... args) {
+        auto [node, inserted] = FindOrEmplace(key, std::forward<Args>(args)...);
+        return {&node->data_.second, inserted};
+    }
+
+    template <typename K, typename... Args>
+        requires IsTransparent
+    std::pair<Value*, bool> TryEmplace(const K& key, Args&&... args) {
+        auto [node, inserted] = FindOrEmplace(key, std::forward<Args>(args)...);
+        return {&node->data_.second, inserted};
+    }
+
+    // Returns true if key was inserted, false if its value was replaced
+    template <typename V>
+    bool InsertOrAssign(const Key& key, V&& value) {
+        auto [node, inserted] = FindOrEmplace(key, std::forward<V>(value));
+        if (!inserted) {
+            node->data_.second = std::forward<V>(value);
+        }
+        return inserted;
+    }
+
+    // The set operations below merge the two inputs in order and build a balanced tree of the
+    // result in O(n + m). The forms taking Map&& reuse the nodes of both inputs, leaving them
+    // empty, and allocate nothing
+
+    // Entries of either map, on equal keys the value of b wins, as if b was inserted into a
+    static Map Union(const Map& a, const Map& b) {
+        return Combine(CopyCursor(a), CopyCursor(b), SetOperation::Union, Map(a.comp_));
+    }
+
+    static Map Union(Map&& a, Map&& b) {
+        return Steal(a, b, SetOperation::Union);
+    }
+
+    // Entries of a whose keys are in b
+    static Map Intersection(const Map& a, const Map& b) {
+        return Combine(CopyCursor(a), CopyCursor(b), SetOperation::Intersection, Map(a.comp_));
+    }
+
+    static Map Intersection(Map&& a, Map&& b) {
+        return Steal(a, b, SetOperation::Intersection);
+    }
+
+    // Entries of a whose keys are not in b
+    static Map Difference(const Map& a, const Map& b) {
+        return Combine(CopyCursor(a), CopyCursor(b), SetOperation::Difference, Map(a.comp_));
+    }
+
+    static Map Difference(Map&& a, Map&& b) {
+        return Steal(a, b, SetOperation::Difference);
+    }
+
+    // Moves every entry of other into this map, replacing the values of equal keys
+    void MergeFrom(Map&& other) {
+        if (this != &other) {
+            *this = Union(std::move(*this), std::move(other));
         }
-        return false;
     }
 
     ~Map() {
@@ -179,46 +657,494 @@ public:
 private:
     class Node {
         friend class Map;
+        template <bool IsConst>
+        friend class BasicOrderedIterator;
         std::pair<const Key, Value> data_;
         Node* left_;
         Node* right_;
+        // Height of the subtree, a leaf has height 1
+        uint8_t height_;
+        [[no_unique_address]] std::conditional_t<OrderStatistics, size_t, NoSubtreeSize> size_;
+
+        template <typename K, typename... Args>
+        explicit Node(const K& key, Args&&... args)
+            : data_(std::piecewise_construct, std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...)),
+              left_(nullptr),
+              right_(nullptr),
+              height_(1),
+              size_() {
+            if constexpr (OrderStatistics) {
+                size_ = 1;
+            }
+        }
     };
 
+    using NodePool = typename Storage::template Pool<sizeof(Node), alignof(Node)>;
+
     Node* root_;
     size_t tree_size_;
     Compare comp_;
+    NodePool pool_;
 
-    void Traverse(Node* node, std::vector<std::pair<const Key, Value>>& result, bool asc) const {
+    void ClearTree(Node* node) noexcept {
         if (node == nullptr) {
             return;
         }
-        if (asc) {
-            Traverse(node->left_, result, asc);
-            result.push_back(node->data_);
-            Traverse(node->right_, result, asc);
-        } else {
-            Traverse(node->right_, result, asc);
-            result.push_back(node->data_);
-            Traverse(node->left_, result, asc);
-        }
+        ClearTree(node->left_);
+        ClearTree(node->right_);
+        DestroyNode(node);
     }
 
-    void ClearTree(Node* node) noexcept {
+    // Runs the destructors only, the slots are released with their slabs
+    static void DestroyTree(Node* node) noexcept {
         if (node == nullptr) {
             return;
         }
-        ClearTree(node->left_);
-        ClearTree(node->right_);
-        node->data_.~pair();
-        delete node;
+        DestroyTree(node->left_);
+        DestroyTree(node->right_);
+        node->~Node();
+    }
+
+    template <typename K, typename... Args>
+    Node* CreateNode(const K& key, Args&&... args) {
+        void* slot = pool_.Acquire();
+        try {
+            return new (slot) Node(key, std::forward<Args>(args)...);
+        } catch (...) {
+            pool_.Release(slot);
+            throw;
+        }
+    }
+
+    void DestroyNode(Node* node) noexcept {
+        node->~Node();
+        pool_.Release(node);
+    }
+
+    // Moves it past a run of equal keys, leaving the last of them in last
+    template <typename Iterator>
+    void SkipEqual(Iterator& it, const Iterator& end, Iterator* last = nullptr) const {
+        Iterator current = it;
+        for (++it; it != end && !comp_(current->first, it->first); ++it) {
+            current = it;
+        }
+        if (last != nullptr) {
+            *last = current;
+        }
+    }
+
+    // Creates the nodes in key order, so an arena lays them out sequentially.
+    // The middle entry becomes the root and subtree sizes differ by at most one
+    template <typename Iterator>
+    Node* BuildBalanced(Iterator& it, const Iterator& end, size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_t left_count = (count - 1) / 2;
+        Node* left = BuildBalanced(it, end, left_count);
+        Node* node;
+        try {
+            Iterator last = it;
+            SkipEqual(it, end, &last);
+            node = CreateNode(last->first, last->second);
+        } catch (...) {
+            ClearTree(left);
+            throw;
+        }
+        node->left_ = left;
+        try {
+            node->right_ = BuildBalanced(it, end, count - 1 - left_count);
+        } catch (...) {
+            ClearTree(node);
+            throw;
+        }
+        UpdateHeight(node);
+        return node;
+    }
+
+    enum class SetOperation { Union, Intersection, Difference };
+
+    // Walks a node list built by Flatten, handing its nodes over
+    class ListCursor {
+    public:
+        explicit ListCursor(Node* head) : head_(head) {
+        }
+
+        bool Done() const noexcept {
+            return head_ == nullptr;
+        }
+
+        const Key& Front() const noexcept {
+            return head_->data_.first;
+        }
+
+        Node* Take(Map&) noexcept {
+            Node* node = head_;
+            head_ = head_->right_;
+            return node;
+        }
+
+        void Drop(Map& owner) noexcept {
+            owner.DestroyNode(Take(owner));
+        }
+
+        void DropRest(Map& owner) noexcept {
+            owner.ClearList(head_);
+            head_ = nullptr;
+        }
+
+    private:
+        Node* head_;
+    };
+
+    // Walks a map in order, handing out copies of its entries
+    class CopyCursor {
+    public:
+        explicit CopyCursor(const Map& map) : it_(map.Ascending().begin()), end_(map.Ascending().end()) {
+        }
+
+        bool Done() const noexcept {
+            return it_ == end_;
+        }
+
+        const Key& Front() const noexcept {
+            return it_->first;
+        }
+
+        Node* Take(Map& owner) {
+            Node* node = owner.CreateNode(it_->first, it_->second);
+            ++it_;
+            return node;
+        }
+
+        void Drop(Map&) noexcept {
+            ++it_;
+        }
+
+        void DropRest(Map&) noexcept {
+            it_ = end_;
+        }
+
+    private:
+        ConstOrderedIterator it_;
+        ConstOrderedIterator end_;
+    };
+
+    static Map Steal(Map& a, Map& b, SetOperation operation) {
+        Map result(a.comp_);
+        result.pool_.Adopt(a.pool_);
+        result.pool_.Adopt(b.pool_);
+        ListCursor first(Flatten(a.root_));
+        ListCursor second(Flatten(b.root_));
+        a.root_ = nullptr;
+        a.tree_size_ = 0;
+        b.root_ = nullptr;
+        b.tree_size_ = 0;
+        return Combine(first, second, operation, std::move(result));
+    }
+
+    // Links the nodes of the entries kept by operation into a list and builds the tree from it
+    template <typename Cursor>
+    static Map Combine(Cursor a, Cursor b, SetOperation operation, Map result) {
+        Node* head = nullptr;
+        Node** tail = &head;
+        size_t count = 0;
+        auto append = [&tail, &count](Node* node) {
+            *tail = node;
+            tail = &node->right_;
+            ++count;
+        };
+        try {
+            while (!a.Done() && !b.Done()) {
+                if (result.comp_(a.Front(), b.Front())) {
+                    if (operation == SetOperation::Intersection) {
+                        a.Drop(result);
+                    } else {
+                        append(a.Take(result));
+                    }
+                } else if (result.comp_(b.Front(), a.Front())) {
+                    if (operation == SetOperation::Union) {
+                        append(b.Take(result));
+                    } else {
+                        b.Drop(result);
+                    }
+                } else if (operation == SetOperation::Union) {
+                    a.Drop(result);
+                    append(b.Take(result));
+                } else if (operation == SetOperation::Intersection) {
+                    append(a.Take(result));
+                    b.Drop(result);
+                } else {
+                    a.Drop(result);
+                    b.Drop(result);
+                }
+            }
+            if (operation == SetOperation::Intersection) {
+                a.DropRest(result);
+            }
+            while (!a.Done()) {
+                append(a.Take(result));
+            }
+            if (operation != SetOperation::Union) {
+                b.DropRest(result);
+            }
+            while (!b.Done()) {
+                append(b.Take(result));
+            }
+        } catch (...) {
+            *tail = nullptr;
+            result.ClearList(head);
+            // Stolen inputs are owned by nothing else once they left their maps
+            a.DropRest(result);
+            b.DropRest(result);
+            throw;
+        }
+        *tail = nullptr;
+        result.root_ = BuildFromList(head, count);
+        result.tree_size_ = count;
+        return result;
+    }
+
+    // Links the nodes in key order through right_, in O(n) without allocating
+    static Node* Flatten(Node* root) noexcept {
+        Node* stack[MaxHeight];
+        size_t depth = 0;
+        Node* head = nullptr;
+        Node* node = root;
+        // Visits the nodes in descending order, pushing each to the front of the list
+        while (node != nullptr || depth > 0) {
+            while (node != nullptr) {
+                stack[depth++] = node;
+                node = node->right_;
+            }
+            node = stack[--depth];
+            Node* left = node->left_;
+            node->right_ = head;
+            head = node;
+            node = left;
+        }
+        return head;
+    }
+
+    // Takes count nodes off the front of the list into a tree shaped like BuildBalanced's
+    static Node* BuildFromList(Node*& head, size_t count) noexcept {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_t left_count = (count - 1) / 2;
+        Node* left = BuildFromList(head, left_count);
+        Node* node = head;
+        head = head->right_;
+        node->left_ = left;
+        node->right_ = BuildFromList(head, count - 1 - left_count);
+        UpdateHeight(node);
+        return node;
+    }
+
+    void ClearList(Node* head) noexcept {
+        while (head != nullptr) {
+            Node* next = head->right_;
+            DestroyNode(head);
+            head = next;
+        }
+    }
+
+    // Unlinks the node behind the last recorded link and rebalances the path
+    void EraseLast(Node** path[], size_t depth) noexcept {
+        Node** link = path[depth - 1];
+        Node* current = *link;
+        if (current->left_ == nullptr || current->right_ == nullptr) {
+            *link = current->left_ != nullptr ? current->left_ : current->right_;
+        } else {
+            // The in-order successor takes the place of the erased node
+            size_t current_depth = depth;
+            Node** min_link = &current->right_;
+            path[depth++] = min_link;
+            while ((*min_link)->left_ != nullptr) {
+                min_link = &(*min_link)->left_;
+                path[depth++] = min_link;
+            }
+            Node* min_node = *min_link;
+            *min_link = min_node->right_;
+            min_node->left_ = current->left_;
+            min_node->right_ = current->right_;
+            min_node->height_ = current->height_;
+            *link = min_node;
+            path[current_depth] = &min_node->right_;
+        }
+        // The last link now holds an untouched subtree
+        --depth;
+        Rebalance(path, depth);
+
+        DestroyNode(current);
+        --tree_size_;
+    }
+
+    // The node with k smaller keys
+    Node* SelectNode(size_t k) const
+        requires OrderStatistics
+    {
+        if (k >= tree_size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        Node* node = root_;
+        while (true) {
+            size_t left = Count(node->left_);
+            if (k < left) {
+                node = node->left_;
+            } else if (k > left) {
+                k -= left + 1;
+                node = node->right_;
+            } else {
+                return node;
+            }
+        }
+    }
+
+    template <typename K>
+    Node* FindNode(const K& key) const {
+        Node* cur = root_;
+        while (cur != nullptr) {
+            if (comp_(key, cur->data_.first)) {
+                cur = cur->left_;
+            } else if (comp_(cur->data_.first, key)) {
+                cur = cur->right_;
+            } else {
+                return cur;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename K>
+    bool EraseKey(const K& key) {
+        Node** path[MaxHeight];
+        size_t depth = 0;
+        Node** link = &root_;
+        while (*link != nullptr) {
+            path[depth++] = link;
+            if (comp_(key, (*link)->data_.first)) {
+                link = &(*link)->left_;
+            } else if (comp_((*link)->data_.first, key)) {
+                link = &(*link)->right_;
+            } else {
+                break;
+            }
+        }
+
+        if (*link == nullptr) {
+            return false;
+        }
+        EraseLast(path, depth);
+        return true;
+    }
+
+    // Returns the node with the key and whether it was created from args
+    template <typename K, typename... Args>
+    std::pair<Node*, bool> FindOrEmplace(const K& key, Args&&... args) {
+        Node** path[MaxHeight];
+        size_t depth = 0;
+        Node** link = &root_;
+        while (*link != nullptr) {
+            path[depth++] = link;
+            if (comp_(key, (*link)->data_.first)) {
+                link = &(*link)->left_;
+            } else if (comp_((*link)->data_.first, key)) {
+                link = &(*link)->right_;
+            } else {
+                return {*link, false};
+            }
+        }
+        Node* node = CreateNode(key, std::forward<Args>(args)...);
+        *link = node;
+        ++tree_size_;
+        Rebalance(path, depth);
+        return {node, true};
+    }
+
+    static int Height(const Node* node) noexcept {
+        return node == nullptr ? 0 : node->height_;
+    }
+
+    static size_t Count(const Node* node) noexcept {
+        return node == nullptr ? 0 : node->size_;
+    }
+
+    static void UpdateSize(Node* node) noexcept {
+        if constexpr (OrderStatistics) {
+            node->size_ = Count(node->left_) + Count(node->right_) + 1;
+        }
+    }
+
+    static void UpdateHeight(Node* node) noexcept {
+        node->height_ = static_cast<uint8_t>(std::max(Height(node->left_), Height(node->right_)) + 1);
+        UpdateSize(node);
+    }
+
+    static Node* RotateLeft(Node* node) noexcept {
+        Node* pivot = node->right_;
+        node->right_ = pivot->left_;
+        pivot->left_ = node;
+        UpdateHeight(node);
+        UpdateHeight(pivot);
+        return pivot;
+    }
+
+    static Node* RotateRight(Node* node) noexcept {
+        Node* pivot = node->left_;
+        node->left_ = pivot->right_;
+        pivot->right_ = node;
+        UpdateHeight(node);
+        UpdateHeight(pivot);
+        return pivot;
+    }
+
+    // Restores the AVL invariant at a node whose subtrees differ in height by at most 2
+    static Node* Balance(Node* node) noexcept {
+        UpdateHeight(node);
+        int balance = Height(node->left_) - Height(node->right_);
+        if (balance > 1) {
+            if (Height(node->left_->left_) < Height(node->left_->right_)) {
+                node->left_ = RotateLeft(node->left_);
+            }
+            return RotateRight(node);
+        }
+        if (balance < -1) {
+            if (Height(node->right_->right_) < Height(node->right_->left_)) {
+                node->right_ = RotateRight(node->right_);
+            }
+            return RotateLeft(node);
+        }
+        return node;
+    }
+
+    // Walks the recorded links bottom-up until a subtree keeps its height
+    static void Rebalance(Node** path[], size_t depth) noexcept {
+        while (depth > 0) {
+            Node** link = path[--depth];
+            int old_height = Height(*link);
+            *link = Balance(*link);
+            if (Height(*link) == old_height) {
+                break;
+            }
+        }
+        // Above the last height change only the subtree sizes differ
+        while (depth > 0) {
+            UpdateSize(*path[--depth]);
+        }
     }
 };
 
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Storage = HeapNodeStorage>
+using OrderStatisticMap = Map<Key, Value, Compare, Storage, true>;
+
 namespace std {
 // Global swap overloading
-template <typename Key, typename Value>
+template <typename Key, typename Value, typename Compare, typename Storage, bool OrderStatistics>
 // NOLINTNEXTLINE
-void swap(Map<Key, Value>& a, Map<Key, Value>& b) {
+void swap(Map<Key, Value, Compare, Storage, OrderStatistics>& a,
+          Map<Key, Value, Compare, Storage, OrderStatistics>& b) {
     a.Swap(b);
 }
 }  // namespace std
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "map.hpp"
+
+// Immutable AVL map. Insert and Erase leave the map untouched and return a new
+// version that copies only the O(log n) nodes on the search path and shares every
+// other subtree with the old one. Nodes are reference counted, so copying a version
+// (taking a snapshot) is O(1) and a node is freed with the last version using it.
+// The counts are atomic: versions can be copied and read from several threads,
+// but a single PersistentMap object must not be assigned while others read it
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class PersistentMap {
+public:
+    explicit PersistentMap(Compare comp = Compare()) : root_(nullptr), size_(0), comp_(std::move(comp)) {
+    }
+
+    PersistentMap(const PersistentMap& other) : root_(Retain(other.root_)), size_(other.size_), comp_(other.comp_) {
+    }
+
+    PersistentMap(PersistentMap&& other) noexcept : root_(other.root_), size_(other.size_), comp_(other.comp_) {
+        other.root_ = nullptr;
+        other.size_ = 0;
+    }
+
+    PersistentMap& operator=(PersistentMap other) noexcept {
+        Swap(other);
+        return *this;
+    }
+
+    ~PersistentMap() {
+        Release(root_);
+    }
+
+    // Builds a perfectly balanced version from pairs sorted by key in O(n).
+    // Of equal keys the last one wins
+    template <typename Range>
+    static PersistentMap FromSorted(const Range& range, Compare comp = Compare()) {
+        std::vector<std::pair<Key, Value>> entries;
+        for (auto it = std::begin(range); it != std::end(range); ++it) {
+            if (!entries.empty() && !comp(entries.back().first, it->first)) {
+                entries.back() = *it;
+            } else {
+                entries.emplace_back(*it);
+            }
+        }
+        return PersistentMap(BuildBalanced(entries.data(), entries.size()), entries.size(), comp);
+    }
+
+    // The version with key set to value, inserted or replaced
+    PersistentMap Insert(const Key& key, const Value& value) const {
+        bool inserted = false;
+        Node* root = InsertNode(root_, key, value, inserted);
+        return PersistentMap(root, inserted ? size_ + 1 : size_, comp_);
+    }
+
+    // The version without key
+    PersistentMap Erase(const Key& key) const {
+        if (FindNode(key) == nullptr) {
+            throw MapIsEmptyException("Value not found");
+        }
+        return PersistentMap(EraseNode(root_, key), size_ - 1, comp_);
+    }
+
+    bool Find(const Key& key) const {
+        return FindNode(key) != nullptr;
+    }
+
+    // The value for key or nullptr, valid while this version is alive
+    const Value* FindPtr(const Key& key) const {
+        const Node* node = FindNode(key);
+        return node != nullptr ? &node->data_.second : nullptr;
+    }
+
+    // Calls visitor(key, value) for every entry in order
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        const Node* stack[MaxHeight];
+        size_t depth = 0;
+        const Node* node = root_;
+        while (node != nullptr || depth > 0) {
+            while (node != nullptr) {
+                stack[depth++] = node;
+                node = is_increase ? node->left_ : node->right_;
+            }
+            node = stack[--depth];
+            visitor(node->data_.first, node->data_.second);
+            node = is_increase ? node->right_ : node->left_;
+        }
+    }
+
+    std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const {
+        std::vector<std::pair<const Key, Value>> result;
+        result.reserve(size_);
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
+        return result;
+    }
+
+    inline size_t Size() const noexcept {
+        return size_;
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    void Swap(PersistentMap& other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(size_, other.size_);
+        std::swap(comp_, other.comp_);
+    }
+
+private:
+    // An AVL tree of height h has at least Fib(h + 2) - 1 nodes, so 64-bit sizes fit in 92 levels
+    static constexpr size_t MaxHeight = 96;
+
+    struct Node {
+        std::pair<const Key, Value> data_;
+        // Owned references
+        Node* left_;
+        Node* right_;
+        uint8_t height_;
+        std::atomic<uint32_t> refs_;
+
+        template <typename... Args>
+        Node(Node* left, Node* right, Args&&... args)
+            : data_(std::forward<Args>(args)...),
+              left_(left),
+              right_(right),
+              height_(static_cast<uint8_t>(std::max(Height(left), Height(right)) + 1)),
+              refs_(1) {
+        }
+    };
+
+    Node* root_;
+    size_t size_;
+    [[no_unique_address]] Compare comp_;
+
+    PersistentMap(Node* root, size_t size, const Compare& comp) : root_(root), size_(size), comp_(comp) {
+    }
+
+    static size_t Height(const Node* node) noexcept {
+        return node == nullptr ? 0 : node->height_;
+    }
+
+    static Node* Retain(Node* node) noexcept {
+        if (node != nullptr) {
+            node->refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    // Recurses only into subtrees that lose their last reference, at most the height deep
+    static void Release(Node* node) noexcept {
+        if (node != nullptr && node->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Release(node->left_);
+            Release(node->right_);
+            delete node;
+        }
+    }
+
+    // Takes over the references to left and right, dropping them if the allocation fails
+    template <typename... Args>
+    static Node* MakeNode(Node* left, Node* right, Args&&... args) {
+        try {
+            return new Node(left, right, std::forward<Args>(args)...);
+        } catch (...) {
+            Release(left);
+            Release(right);
+            throw;
+        }
+    }
+
+    const Node* FindNode(const Key& key) const {
+        const Node* node = root_;
+        while (node != nullptr) {
+            if (comp_(key, node->data_.first)) {
+                node = node->left_;
+            } else if (comp_(node->data_.first, key)) {
+                node = node->right_;
+            } else {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    static Node* BuildBalanced(std::pair<Key, Value>* entries, size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_t middle = (count - 1) / 2;
+        Node* left = BuildBalanced(entries, middle);
+        Node* right;
+        try {
+            right = BuildBalanced(entries + middle + 1, count - 1 - middle);
+        } catch (...) {
+            Release(left);
+            throw;
+        }
+        return MakeNode(left, right, std::move(entries[middle].first), std::move(entries[middle].second));
+    }
+
+    // A new node holding data over the owned subtrees left and right, rotated if
+    // their heights differ by two. Nodes taken apart by a rotation are copied, as
+    // other versions may share them
+    static Node* Balance(const std::pair<const Key, Value>& data, Node* left, Node* right) {
+        if (Height(left) > Height(right) + 1) {
+            Node* result;
+            try {
+                if (Height(left->left_) >= Height(left->right_)) {
+                    Node* inner = MakeNode(Retain(left->right_), right, data);
+                    result = MakeNode(Retain(left->left_), inner, left->data_);
+                } else {
+                    Node* pivot = left->right_;
+                    Node* inner = MakeNode(Retain(pivot->right_), right, data);
+                    Node* outer;
+                    try {
+                        outer = MakeNode(Retain(left->left_), Retain(pivot->left_), left->data_);
+                    } catch (...) {
+                        Release(inner);
+                        throw;
+                    }
+                    result = MakeNode(outer, inner, pivot->data_);
+                }
+            } catch (...) {
+                Release(left);
+                throw;
+            }
+            Release(left);
+            return result;
+        }
+        if (Height(right) > Height(left) + 1) {
+            Node* result;
+            try {
+                if (Height(right->right_) >= Height(right->left_)) {
+                    Node* inner = MakeNode(left, Retain(right->left_), data);
+                    result = MakeNode(inner, Retain(right->right_), right->data_);
+                } else {
+                    Node* pivot = right->left_;
+                    Node* inner = MakeNode(left, Retain(pivot->left_), data);
+                    Node* outer;
+                    try {
+                        outer = MakeNode(Retain(pivot->right_), Retain(right->right_), right->data_);
+                    } catch (...) {
+                        Release(inner);
+                        throw;
+                    }
+                    result = MakeNode(inner, outer, pivot->data_);
+                }
+            } catch (...) {
+                Release(right);
+                throw;
+            }
+            Release(right);
+            return result;
+        }
+        return MakeNode(left, right, data);
+    }
+
+    Node* InsertNode(const Node* node, const Key& key, const Value& value, bool& inserted) const {
+        if (node == nullptr) {
+            inserted = true;
+            return MakeNode(nullptr, nullptr, key, value);
+        }
+        if (comp_(key, node->data_.first)) {
+            Node* left = InsertNode(node->left_, key, value, inserted);
+            return Balance(node->data_, left, Retain(node->right_));
+        }
+        if (comp_(node->data_.first, key)) {
+            Node* right = InsertNode(node->right_, key, value, inserted);
+            return Balance(node->data_, Retain(node->left_), right);
+        }
+        inserted = false;
+        return MakeNode(Retain(node->left_), Retain(node->right_), node->data_.first, value);
+    }
+
+    // key must be present
+    Node* EraseNode(const Node* node, const Key& key) const {
+        if (comp_(key, node->data_.first)) {
+            Node* left = EraseNode(node->left_, key);
+            return Balance(node->data_, left, Retain(node->right_));
+        }
+        if (comp_(node->data_.first, key)) {
+            Node* right = EraseNode(node->right_, key);
+            return Balance(node->data_, Retain(node->left_), right);
+        }
+        if (node->left_ == nullptr) {
+            return Retain(node->right_);
+        }
+        if (node->right_ == nullptr) {
+            return Retain(node->left_);
+        }
+        // The successor takes the place of the erased node
+        const Node* successor = node->right_;
+        while (successor->left_ != nullptr) {
+            successor = successor->left_;
+        }
+        Node* right = EraseMin(node->right_);
+        return Balance(successor->data_, Retain(node->left_), right);
+    }
+
+    Node* EraseMin(const Node* node) const {
+        if (node->left_ == nullptr) {
+            return Retain(node->right_);
+        }
+        Node* left = EraseMin(node->left_);
+        return Balance(node->data_, left, Retain(node->right_));
+    }
+};
+
+namespace std {
+// Global swap overloading
+template <typename Key, typename Value, typename Compare>
+// NOLINTNEXTLINE
+void swap(PersistentMap<Key, Value, Compare>& a, PersistentMap<Key, Value, Compare>& b) noexcept {
+    a.Swap(b);
+}
+}  // namespace std
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../common/epoch_reclamation.hpp"
+
+// Ordered map shared between threads, a lock-free skip list.
+// Every level is a Harris-Michael list: Erase marks the low bit of the victim's
+// next pointers from the top level down, and the thread that marks level 0 owns
+// the removal. Searches that meet a marked node unlink it. Lookups and scans only
+// read and never retry. Values are immutable once inserted.
+// A node is retired once both its inserter and its eraser are done with it, so it
+// is unreachable by then, and freed with epoch based reclamation: every operation
+// and every view holds a guard of the map's EpochDomain
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class SkipListMap {
+private:
+    static constexpr size_t MaxLevel = 32;
+
+    using Link = std::atomic<std::uintptr_t>;
+
+    // The links of the node's levels are laid out right after it, in the same allocation
+    struct Node {
+        std::pair<const Key, Value> data_;
+        size_t level_;
+        // The inserter and the eraser each drop one, the last of them retires the node
+        std::atomic<uint32_t> owners_;
+        Node* retired_next_;
+        uint64_t retired_epoch_;
+
+        Node(const Key& key, const Value& value, size_t level)
+            : data_(key, value), level_(level), owners_(2), retired_next_(nullptr), retired_epoch_(0) {
+        }
+
+        // Address of the next node on the level, the low bit marks this node as erased
+        Link& Next(size_t level) noexcept {
+            return std::launder(reinterpret_cast<Link*>(this + 1))[level];
+        }
+
+        const Link& Next(size_t level) const noexcept {
+            return std::launder(reinterpret_cast<const Link*>(this + 1))[level];
+        }
+    };
+
+    static void DestroyNode(Node* node) noexcept {
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    struct NodeReclaim {
+        void operator()(Node* node) const noexcept {
+            DestroyNode(node);
+        }
+    };
+
+    using Epochs = EpochDomain<Node, NodeReclaim>;
+    using Guard = typename Epochs::Guard;
+
+public:
+    // Walks level 0 skipping erased nodes. Keys only grow along the walk, entries
+    // present for the whole walk are visited, concurrent updates may or may not be
+    class OrderedIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key, Value>;
+        // NOLINTNEXTLINE
+        using reference_type = const value_type&;
+        // NOLINTNEXTLINE
+        using pointer_type = const value_type*;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::forward_iterator_tag;
+
+        OrderedIterator() : node_(nullptr) {
+        }
+
+        inline bool operator==(const OrderedIterator& other) const {
+            return node_ == other.node_;
+        }
+
+        inline bool operator!=(const OrderedIterator& other) const {
+            return node_ != other.node_;
+        }
+
+        inline reference_type operator*() const {
+            return node_->data_;
+        }
+
+        inline pointer_type operator->() const {
+            return &node_->data_;
+        }
+
+        OrderedIterator& operator++() {
+            node_ = SkipErased(AsNode(node_->Next(0).load(std::memory_order_acquire)));
+            return *this;
+        }
+
+        OrderedIterator operator++(int) {
+            OrderedIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+    private:
+        friend class SkipListMap;
+
+        const Node* node_;
+
+        explicit OrderedIterator(const Node* node) : node_(SkipErased(node)) {
+        }
+    };
+
+    // Keeps the calling thread pinned while alive, so its iterators stay valid under
+    // concurrent erases. Nodes erased meanwhile are not freed until it is destroyed
+    class OrderedView {
+    public:
+        OrderedView(const OrderedView&) = delete;
+        OrderedView& operator=(const OrderedView&) = delete;
+
+        // NOLINTNEXTLINE
+        OrderedIterator begin() const {
+            return first_;
+        }
+
+        // NOLINTNEXTLINE
+        OrderedIterator end() const {
+            return OrderedIterator();
+        }
+
+    private:
+        friend class SkipListMap;
+
+        Guard guard_;
+        OrderedIterator first_;
+
+        OrderedView(const SkipListMap& map, const Key* from)
+            : guard_(map.epochs_),
+              first_(from != nullptr ? map.LowerBoundNode(*from)
+                                     : AsNode(map.head_[0].load(std::memory_order_acquire))) {
+        }
+    };
+
+    explicit SkipListMap(Compare comp = Compare()) : comp_(std::move(comp)), size_(0) {
+        for (auto& link : head_) {
+            link.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SkipListMap(const SkipListMap&) = delete;
+    SkipListMap& operator=(const SkipListMap&) = delete;
+
+    // Returns false and keeps the old value if key is already present
+    bool Insert(const Key& key, const Value& value) {
+        Guard guard(epochs_);
+        Link* preds[MaxLevel];
+        Node* succs[MaxLevel];
+        Node* node = nullptr;
+        while (true) {
+            if (Search(key, preds, succs)) {
+                // A node is only built once the key was missing, a later pass may still find it
+                if (node != nullptr) {
+                    DestroyNode(node);
+                }
+                return false;
+            }
+            if (node == nullptr) {
+                node = CreateNode(key, value, RandomLevel());
+            }
+            for (size_t level = 0; level < node->level_; ++level) {
+                node->Next(level).store(Address(succs[level]), std::memory_order_relaxed);
+            }
+            std::uintptr_t expected = Address(succs[0]);
+            if (preds[0]->compare_exchange_strong(expected, Address(node), std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+        // The node is in the map now, the upper levels are only shortcuts to it
+        for (size_t level = 1; level < node->level_; ++level) {
+            while (true) {
+                std::uintptr_t next = node->Next(level).load(std::memory_order_acquire);
+                if (IsMarked(next)) {
+                    break;
+                }
+                if (next != Address(succs[level]) &&
+                    !node->Next(level).compare_exchange_strong(next, Address(succs[level]), std::memory_order_release,
+                                                               std::memory_order_relaxed)) {
+                    break;
+                }
+                std::uintptr_t expected = Address(succs[level]);
+                if (preds[level]->compare_exchange_strong(expected, Address(node), std::memory_order_release,
+                                                          std::memory_order_relaxed)) {
+                    break;
+                }
+                if (!Search(key, preds, succs) || succs[0] != node) {
+                    // Erased meanwhile, the eraser stops the linking by marking every level
+                    break;
+                }
+            }
+        }
+        if (IsMarked(node->Next(0).load(std::memory_order_acquire))) {
+            // Erased while being linked: unlink whatever was linked after the eraser's search
+            Search(key, preds, succs);
+        }
+        Disown(node, guard);
+        return true;
+    }
+
+    bool Erase(const Key& key) {
+        Guard guard(epochs_);
+        Link* preds[MaxLevel];
+        Node* succs[MaxLevel];
+        if (!Search(key, preds, succs)) {
+            return false;
+        }
+        Node* node = succs[0];
+        for (size_t level = node->level_ - 1; level > 0; --level) {
+            node->Next(level).fetch_or(MarkBit, std::memory_order_acq_rel);
+        }
+        // Logical removal: the node is erased once its level 0 link is marked
+        std::uintptr_t next = node->Next(0).load(std::memory_order_acquire);
+        do {
+            if (IsMarked(next)) {
+                return false;
+            }
+        } while (!node->Next(0).compare_exchange_weak(next, next | MarkBit, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire));
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        Search(key, preds, succs);
+        Disown(node, guard);
+        return true;
+    }
+
+    // Lock-free lookup that only reads
+    bool Contains(const Key& key) const {
+        Guard guard(epochs_);
+        return FindNode(key) != nullptr;
+    }
+
+    // A copy of the value, as the node may be freed once the lookup ends
+    std::optional<Value> TryGet(const Key& key) const {
+        Guard guard(epochs_);
+        if (const Node* node = FindNode(key)) {
+            return node->data_.second;
+        }
+        return std::nullopt;
+    }
+
+    OrderedView Ascending() const {
+        return OrderedView(*this, nullptr);
+    }
+
+    // Entries from the first key not less than key
+    OrderedView LowerBound(const Key& key) const {
+        return OrderedView(*this, &key);
+    }
+
+    std::vector<std::pair<const Key, Value>> Values() const {
+        std::vector<std::pair<const Key, Value>> result;
+        for (const auto& entry : Ascending()) {
+            result.push_back(entry);
+        }
+        return result;
+    }
+
+    // Exact when no updates are in flight
+    inline size_t Size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    inline bool IsEmpty() const noexcept {
+        return Size() == 0;
+    }
+
+    // Must not run concurrently with other operations
+    ~SkipListMap() {
+        for (Node* curr = AsNode(head_[0].load(std::memory_order_relaxed)); curr;) {
+            Node* next = AsNode(curr->Next(0).load(std::memory_order_relaxed));
+            DestroyNode(curr);
+            curr = next;
+        }
+    }
+
+private:
+    static constexpr std::uintptr_t MarkBit = 1;
+
+    Link head_[MaxLevel];
+    Compare comp_;
+    std::atomic<size_t> size_;
+    Epochs epochs_;
+
+    static std::uintptr_t Address(const Node* node) noexcept {
+        return reinterpret_cast<std::uintptr_t>(node);
+    }
+
+    static bool IsMarked(std::uintptr_t link) noexcept {
+        return (link & MarkBit) != 0;
+    }
+
+    static Node* AsNode(std::uintptr_t link) noexcept {
+        return reinterpret_cast<Node*>(link & ~MarkBit);
+    }
+
+    static Node* CreateNode(const Key& key, const Value& value, size_t level) {
+        void* memory = ::operator new(sizeof(Node) + level * sizeof(Link));
+        Node* node;
+        try {
+            node = new (memory) Node(key, value, level);
+        } catch (...) {
+            ::operator delete(memory);
+            throw;
+        }
+        auto* links = reinterpret_cast<Link*>(node + 1);
+        for (size_t i = 0; i < level; ++i) {
+            new (links + i) Link(0);
+        }
+        return node;
+    }
+
+    static const Node* SkipErased(const Node* node) noexcept {
+        while (node != nullptr) {
+            std::uintptr_t next = node->Next(0).load(std::memory_order_acquire);
+            if (!IsMarked(next)) {
+                return node;
+            }
+            node = AsNode(next);
+        }
+        return nullptr;
+    }
+
+    // Level l with probability 2^-l
+    static size_t RandomLevel() {
+        thread_local std::mt19937 generator(std::random_device{}());
+        auto bits = static_cast<uint32_t>(generator());
+        return std::min<size_t>(std::countr_zero(bits) + 1, MaxLevel);
+    }
+
+    Link* LinkAt(Node* pred, size_t level) noexcept {
+        return pred != nullptr ? &pred->Next(level) : &head_[level];
+    }
+
+    const Link* LinkAt(const Node* pred, size_t level) const noexcept {
+        return pred != nullptr ? &pred->Next(level) : &head_[level];
+    }
+
+    // Fills the last link before key and the first node not less than key on every
+    // level, unlinking marked nodes on the way. Returns whether that node holds key
+    bool Search(const Key& key, Link** preds, Node** succs) {
+        while (true) {
+            bool restart = false;
+            Node* pred = nullptr;
+            for (size_t level = MaxLevel; level-- > 0 && !restart;) {
+                Link* link = LinkAt(pred, level);
+                Node* curr = AsNode(link->load(std::memory_order_acquire));
+                while (curr != nullptr) {
+                    std::uintptr_t next = curr->Next(level).load(std::memory_order_acquire);
+                    if (IsMarked(next)) {
+                        std::uintptr_t expected = Address(curr);
+                        if (!link->compare_exchange_strong(expected, next & ~MarkBit, std::memory_order_acq_rel,
+                                                           std::memory_order_acquire)) {
+                            restart = true;
+                            break;
+                        }
+                        curr = AsNode(next);
+                        continue;
+                    }
+                    if (!comp_(curr->data_.first, key)) {
+                        break;
+                    }
+                    pred = curr;
+                    link = &curr->Next(level);
+                    curr = AsNode(next);
+                }
+                preds[level] = link;
+                succs[level] = curr;
+            }
+            if (!restart) {
+                return succs[0] != nullptr && !comp_(key, succs[0]->data_.first);
+            }
+        }
+    }
+
+    // The first node not less than key that is not erased, without unlinking anything
+    const Node* LowerBoundNode(const Key& key) const {
+        const Node* pred = nullptr;
+        const Node* curr = nullptr;
+        for (size_t level = MaxLevel; level-- > 0;) {
+            curr = AsNode(LinkAt(pred, level)->load(std::memory_order_acquire));
+            while (curr != nullptr && comp_(curr->data_.first, key)) {
+                pred = curr;
+                curr = AsNode(curr->Next(level).load(std::memory_order_acquire));
+            }
+        }
+        return SkipErased(curr);
+    }
+
+    const Node* FindNode(const Key& key) const {
+        const Node* node = LowerBoundNode(key);
+        return node != nullptr && !comp_(key, node->data_.first) ? node : nullptr;
+    }
+
+    void Disown(Node* node, const Guard& guard) {
+        if (node->owners_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            epochs_.Retire(node, guard);
+        }
+    }
+};
@@ -1,11 +1,22 @@
+#include <algorithm>
+#include <memory>
 #include <random>
 #include <map>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
 
+#include "../art_map.hpp"
+#include "../btree_map.hpp"
+#include "../concurrent_map.hpp"
 #include "../map.hpp"
+#include "../persistent_map.hpp"
+#include "../skip_list_map.hpp"
+#include "../../../common/mixed_workload.hpp"
 
 void ConstructRandomMap(Map<int, int>& mp, int sz) {
   std::random_device rd;
@@ -114,32 +125,715 @@ void BM_StdMapErase(benchmark::State& state) {
   state.SetComplexityN(state.range(0));
 }
 
-void BM_CustomMapClear(benchmark::State& state) {
-  Map<int, int> mp;
+
+void BM_StdMapClear(benchmark::State& state) {
+  std::map<int, int> mp;
   for (auto _ : state) {
     ConstructRandomMap(mp, state.range(0));
+    mp.clear();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+
+template <typename MapType>
+void ConstructRandomCustomMap(MapType& mp, int sz) {
+  std::mt19937 mt(sz);
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  while(sz) {
+    mp.Insert(std::pair{dist(mt), 1});
+    --sz;
+  }
+}
+
+template <typename Storage>
+void BM_CustomMapClear(benchmark::State& state) {
+  Map<int, int, std::less<int>, Storage> mp;
+  for (auto _ : state) {
+    ConstructRandomCustomMap(mp, state.range(0));
     mp.Clear();
   }
   state.SetComplexityN(state.range(0));
 }
 
-void BM_StdMapClear(benchmark::State& state) {
+template <typename MapType>
+void ConstructLinearCustomMap(MapType& mp, int sz) {
+  while(sz) {
+    mp.Insert(std::pair{sz, 1});
+    --sz;
+  }
+}
+
+// Every key of a map built by ConstructRandomCustomMap(sz), in a different order
+std::vector<int> RandomLookups(int sz) {
+  std::mt19937 mt(sz);
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  std::vector<int> keys(sz);
+  for (auto& key : keys) {
+    key = dist(mt);
+  }
+  std::shuffle(keys.begin(), keys.end(), mt);
+  return keys;
+}
+
+void BM_BTreeMapRandomInsert(benchmark::State& state) {
+  BTreeMap<int, int> mp;
+  for (auto _ : state) {
+    ConstructRandomCustomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_BTreeMapLinearInsert(benchmark::State& state) {
+  BTreeMap<int, int> mp;
+  for (auto _ : state) {
+    ConstructLinearCustomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template <typename MapType>
+void RunCustomFind(benchmark::State& state) {
+  MapType mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  std::vector<int> keys = RandomLookups(state.range(0));
+  for (auto _ : state) {
+    for (int key : keys) {
+      benchmark::DoNotOptimize(mp.Find(key));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_BTreeMapFind(benchmark::State& state) {
+  RunCustomFind<BTreeMap<int, int>>(state);
+}
+
+void BM_CustomMapFind(benchmark::State& state) {
+  RunCustomFind<Map<int, int>>(state);
+}
+
+void BM_StdMapFind(benchmark::State& state) {
   std::map<int, int> mp;
+  std::mt19937 mt(state.range(0));
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    mp.insert(std::pair{dist(mt), 1});
+  }
+  std::vector<int> keys = RandomLookups(state.range(0));
   for (auto _ : state) {
-    ConstructRandomMap(mp, state.range(0));
-    mp.clear();
+    for (int key : keys) {
+      benchmark::DoNotOptimize(mp.find(key));
+    }
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template <typename MapType>
+void RunCustomValues(benchmark::State& state) {
+  MapType mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mp.Values());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_BTreeMapValues(benchmark::State& state) {
+  RunCustomValues<BTreeMap<int, int>>(state);
+}
+
+void BM_CustomMapValues(benchmark::State& state) {
+  RunCustomValues<Map<int, int>>(state);
+}
+
+void BM_StdMapValues(benchmark::State& state) {
+  std::map<int, int> mp;
+  std::mt19937 mt(state.range(0));
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    mp.insert(std::pair{dist(mt), 1});
+  }
+  for (auto _ : state) {
+    std::vector<std::pair<const int, int>> values(mp.begin(), mp.end());
+    benchmark::DoNotOptimize(values);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template <typename MapType>
+void RunCustomForEach(benchmark::State& state) {
+  MapType mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    mp.ForEach([&sum](const int& key, int& value) { sum += key + value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_BTreeMapForEach(benchmark::State& state) {
+  RunCustomForEach<BTreeMap<int, int>>(state);
+}
+
+void BM_CustomMapForEach(benchmark::State& state) {
+  RunCustomForEach<Map<int, int>>(state);
+}
+
+void BM_CustomMapAscending(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const auto& [key, value] : mp.Ascending()) {
+      sum += key + value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+std::vector<std::pair<int, int>> RandomEntries(int sz, bool sorted) {
+  std::vector<std::pair<int, int>> entries;
+  std::mt19937 mt(sz);
+  std::uniform_int_distribution<int> dist(INT_MIN, INT_MAX);
+  for (int i = 0; i < sz; ++i) {
+    entries.emplace_back(sorted ? i : dist(mt), i);
+  }
+  return entries;
+}
+
+template <typename Storage>
+void BM_CustomMapInsertLoad(benchmark::State& state) {
+  auto entries = RandomEntries(state.range(0), state.range(1));
+  for (auto _ : state) {
+    Map<int, int, std::less<int>, Storage> mp;
+    for (const auto& entry : entries) {
+      mp.Insert(entry);
+    }
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template <typename Storage>
+void BM_CustomMapBulkLoad(benchmark::State& state) {
+  using MapType = Map<int, int, std::less<int>, Storage>;
+  auto entries = RandomEntries(state.range(0), state.range(1));
+  for (auto _ : state) {
+    auto mp = state.range(1) ? MapType::FromSorted(entries) : MapType::FromUnsorted(entries);
+    benchmark::DoNotOptimize(mp.Size());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_OrderStatisticMapRandomInsert(benchmark::State& state) {
+  for (auto _ : state) {
+    OrderStatisticMap<int, int> mp;
+    ConstructRandomCustomMap(mp, state.range(0));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_OrderStatisticMapSelect(benchmark::State& state) {
+  OrderStatisticMap<int, int> mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  std::mt19937 mt(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mp.Select(mt() % mp.Size()).second);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapValuesSelect(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  std::mt19937 mt(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mp.Values()[mt() % mp.Size()].second);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_OrderStatisticMapCountRange(benchmark::State& state) {
+  OrderStatisticMap<int, int> mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  std::mt19937 mt(state.range(0));
+  for (auto _ : state) {
+    int lo = static_cast<int>(mt());
+    benchmark::DoNotOptimize(mp.CountRange(lo, lo / 2 + INT_MAX / 2));
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapValuesCountRange(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  std::mt19937 mt(state.range(0));
+  for (auto _ : state) {
+    int lo = static_cast<int>(mt());
+    int hi = lo / 2 + INT_MAX / 2;
+    auto values = mp.Values();
+    auto less = [](const std::pair<const int, int>& entry, int key) { return entry.first < key; };
+    auto first = std::lower_bound(values.begin(), values.end(), lo, less);
+    auto last = std::lower_bound(values.begin(), values.end(), hi, less);
+    benchmark::DoNotOptimize(first < last ? last - first : 0);
   }
   state.SetComplexityN(state.range(0));
 }
 
+// Allocations made through CountingAllocator, so only the containers of the
+// benchmark that opts in are counted
+size_t counted_allocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+  // NOLINTNEXTLINE
+  using value_type = T;
+
+  CountingAllocator() = default;
+
+  template <typename U>
+  // NOLINTNEXTLINE
+  CountingAllocator(const CountingAllocator<U>&) noexcept {
+  }
+
+  // NOLINTNEXTLINE
+  T* allocate(size_t count) {
+    ++counted_allocations;
+    return std::allocator<T>().allocate(count);
+  }
+
+  // NOLINTNEXTLINE
+  void deallocate(T* ptr, size_t count) noexcept {
+    std::allocator<T>().deallocate(ptr, count);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+using CountedString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+
+// Looks up path-like keys, too long for the small string buffer, given as string views
+template <typename Compare>
+void BM_StringMapViewLookup(benchmark::State& state) {
+  Map<CountedString, int, Compare> mp;
+  std::vector<CountedString> keys;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    keys.emplace_back(fmt::format("/home/user/projects/directory_{:08}", i));
+    mp[keys.back()] = static_cast<int>(i);
+  }
+  std::mt19937 mt(state.range(0));
+  size_t allocations_before = counted_allocations;
+  size_t lookups = 0;
+  for (auto _ : state) {
+    std::string_view key = keys[mt() % keys.size()];
+    if constexpr (requires { typename Compare::is_transparent; }) {
+      benchmark::DoNotOptimize(mp.Find(key));
+    } else {
+      benchmark::DoNotOptimize(mp.Find(CountedString(key)));
+    }
+    ++lookups;
+  }
+  state.counters["allocs_per_lookup"] =
+      static_cast<double>(counted_allocations - allocations_before) / static_cast<double>(lookups);
+  state.SetComplexityN(state.range(0));
+}
+
+// Comparisons made through CountingLess, reported per lookup
+size_t comparison_count = 0;
+
+struct CountingLess {
+  bool operator()(int a, int b) const {
+    ++comparison_count;
+    return a < b;
+  }
+};
+
+template <bool SingleDescent>
+void BM_CustomMapCheckedLookup(benchmark::State& state) {
+  Map<int, int, CountingLess> mp;
+  ConstructRandomCustomMap(mp, state.range(0));
+  auto values = mp.Values();
+  std::mt19937 mt(state.range(0));
+  size_t comparisons_before = comparison_count;
+  size_t lookups = 0;
+  for (auto _ : state) {
+    int key = values[mt() % values.size()].first;
+    if constexpr (SingleDescent) {
+      if (int* value = mp.FindPtr(key)) {
+        benchmark::DoNotOptimize(*value);
+      }
+    } else {
+      if (mp.Find(key)) {
+        benchmark::DoNotOptimize(mp[key]);
+      }
+    }
+    ++lookups;
+  }
+  state.counters["cmp_per_lookup"] =
+      static_cast<double>(comparison_count - comparisons_before) / static_cast<double>(lookups);
+  state.SetComplexityN(state.range(0));
+}
+
+constexpr int ConcurrentKeys = 1 << 16;
+
+// The baseline: one mutex around a single Map
+class LockedMap {
+public:
+  bool Contains(int key) {
+    std::lock_guard lock(mutex_);
+    return map_.Find(key);
+  }
+
+  bool Insert(int key, int value) {
+    std::lock_guard lock(mutex_);
+    return map_.TryEmplace(key, value).second;
+  }
+
+  bool Erase(int key) {
+    std::lock_guard lock(mutex_);
+    return map_.TryErase(key);
+  }
+
+private:
+  std::mutex mutex_;
+  Map<int, int> map_;
+};
+
+bool InsertKey(auto& mp, int key) {
+  return mp.Insert(key, key);
+}
+
+void BM_ConcurrentMapMixed(benchmark::State& state) {
+  RunMixedWorkload<ConcurrentMap<int, int>>(state, ConcurrentKeys, InsertKey<ConcurrentMap<int, int>>);
+}
+
+void BM_LockedMapMixed(benchmark::State& state) {
+  RunMixedWorkload<LockedMap>(state, ConcurrentKeys, InsertKey<LockedMap>);
+}
+
+void BM_SkipListMapMixed(benchmark::State& state) {
+  RunMixedWorkload<SkipListMap<int, int>>(state, ConcurrentKeys, InsertKey<SkipListMap<int, int>>);
+}
+
+// Versions kept alive at once, as if readers still held their snapshots
+constexpr size_t LiveVersions = 4;
+
+// Copies of a VersionedValue. Every node a map builds copies its entry once and nothing
+// else copies them, so the count tells how many nodes the versions allocated
+size_t value_copies = 0;
+
+struct VersionedValue {
+  int value;
+
+  // Implicit, so the maps can be built from the int pairs of EvenKeyPairs
+  VersionedValue(int value) : value(value) {
+  }
+
+  VersionedValue(const VersionedValue& other) : value(other.value) {
+    ++value_copies;
+  }
+
+  VersionedValue& operator=(const VersionedValue&) = default;
+};
+
+// range(1) keys are inserted or erased between consecutive versions
+template <typename VersionedMap>
+void ApplyDelta(VersionedMap& mp, std::mt19937& mt, int64_t size, int64_t delta) {
+  for (int64_t i = 0; i < delta; ++i) {
+    int key = static_cast<int>(mt() % static_cast<uint64_t>(2 * size));
+    VersionedValue value(key);
+    if constexpr (requires { mp.Insert(key, value).Size(); }) {
+      mp = key % 2 == 0 && mp.Find(key) ? mp.Erase(key) : mp.Insert(key, value);
+    } else if (key % 2 == 0 && mp.Find(key)) {
+      mp.Erase(key);
+    } else {
+      mp.InsertOrAssign(key, value);
+    }
+  }
+}
+
+std::vector<std::pair<int, int>> EvenKeyPairs(int64_t size) {
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    pairs.emplace_back(2 * i, i);
+  }
+  return pairs;
+}
+
+void ReportPerVersion(benchmark::State& state, size_t copies_before) {
+  state.counters["nodes_per_version"] =
+      static_cast<double>(value_copies - copies_before) / static_cast<double>(state.iterations());
+}
+
+// A version shares all but the copied search paths with the previous one
+void BM_PersistentMapVersion(benchmark::State& state) {
+  auto base = PersistentMap<int, VersionedValue>::FromSorted(EvenKeyPairs(state.range(0)));
+  std::vector<PersistentMap<int, VersionedValue>> versions(LiveVersions, base);
+  std::mt19937 mt(state.range(0));
+  size_t current = 0;
+  size_t copies_before = value_copies;
+  for (auto _ : state) {
+    PersistentMap<int, VersionedValue> next = versions[current];
+    ApplyDelta(next, mt, state.range(0), state.range(1));
+    current = (current + 1) % LiveVersions;
+    versions[current] = std::move(next);
+  }
+  ReportPerVersion(state, copies_before);
+}
+
+// The baseline: every version is a full copy of the previous one
+void BM_CustomMapCopyVersion(benchmark::State& state) {
+  std::vector<Map<int, VersionedValue>> versions;
+  for (size_t i = 0; i < LiveVersions; ++i) {
+    versions.push_back(Map<int, VersionedValue>::FromSorted(EvenKeyPairs(state.range(0))));
+  }
+  std::mt19937 mt(state.range(0));
+  size_t current = 0;
+  size_t copies_before = value_copies;
+  for (auto _ : state) {
+    auto next = Map<int, VersionedValue>::FromSorted(versions[current].Ascending());
+    ApplyDelta(next, mt, state.range(0), state.range(1));
+    current = (current + 1) % LiveVersions;
+    versions[current] = std::move(next);
+  }
+  ReportPerVersion(state, copies_before);
+}
+
+// Lookups per probe set, cycled so the measured loop does not walk a huge array
+constexpr size_t ProbeCount = 1 << 16;
+
+std::vector<int> ProbeKeys(const std::vector<int>& keys) {
+  std::mt19937 mt(keys.size());
+  std::vector<int> probes(ProbeCount);
+  for (auto& probe : probes) {
+    probe = keys[mt() % keys.size()];
+  }
+  return probes;
+}
+
+template <typename Lookup>
+void RunProbes(benchmark::State& state, const std::vector<int>& probes, Lookup lookup) {
+  size_t index = 0;
+  for (auto _ : state) {
+    lookup(probes[index++ & (ProbeCount - 1)]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_FrozenMapLookup(benchmark::State& state) {
+  std::vector<int> keys = RandomLookups(state.range(0));
+  Map<int, int> mp;
+  for (int key : keys) {
+    mp[key] = key;
+  }
+  auto frozen = mp.Freeze();
+  mp.Clear();
+  RunProbes(state, ProbeKeys(keys), [&frozen](int key) { benchmark::DoNotOptimize(frozen.FindPtr(key)); });
+}
+
+void BM_CustomMapLookup(benchmark::State& state) {
+  std::vector<int> keys = RandomLookups(state.range(0));
+  Map<int, int> mp;
+  for (int key : keys) {
+    mp[key] = key;
+  }
+  RunProbes(state, ProbeKeys(keys), [&mp](int key) { benchmark::DoNotOptimize(mp.FindPtr(key)); });
+}
+
+void BM_StdMapLookup(benchmark::State& state) {
+  std::vector<int> keys = RandomLookups(state.range(0));
+  std::map<int, int> mp;
+  for (int key : keys) {
+    mp[key] = key;
+  }
+  RunProbes(state, ProbeKeys(keys), [&mp](int key) { benchmark::DoNotOptimize(mp.find(key)); });
+}
+
+void BM_ArtMapLookup(benchmark::State& state) {
+  std::vector<int> keys = RandomLookups(state.range(0));
+  ArtMap<int, int> mp;
+  for (int key : keys) {
+    mp[key] = key;
+  }
+  RunProbes(state, ProbeKeys(keys), [&mp](int key) { benchmark::DoNotOptimize(mp.FindPtr(key)); });
+}
+
+// Keys shaped like source tree paths: long shared directory prefixes, branching late
+std::vector<std::string> PathKeys(int64_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    keys.push_back(fmt::format("/home/user/projects/repo_{}/src/module_{}/file_{}.cpp", i % 7, i / 7 % 97, i));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(count));
+  return keys;
+}
+
+template <typename MapType>
+void BM_PathMapInsert(benchmark::State& state) {
+  std::vector<std::string> keys = PathKeys(state.range(0));
+  for (auto _ : state) {
+    MapType mp;
+    for (const auto& key : keys) {
+      mp[key] = 1;
+    }
+    benchmark::DoNotOptimize(mp);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename MapType>
+void BM_PathMapLookup(benchmark::State& state) {
+  std::vector<std::string> keys = PathKeys(state.range(0));
+  MapType mp;
+  for (const auto& key : keys) {
+    mp[key] = 1;
+  }
+  std::mt19937 mt(state.range(0));
+  for (auto _ : state) {
+    const std::string& key = keys[mt() % keys.size()];
+    if constexpr (requires { mp.FindPtr(key); }) {
+      benchmark::DoNotOptimize(mp.FindPtr(key));
+    } else {
+      benchmark::DoNotOptimize(mp.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Two maps of size random keys from [0, 2 * size), so about a third of the keys are in both
+std::pair<Map<int, int>, Map<int, int>> OverlappingMaps(int64_t size) {
+  std::mt19937 mt(size);
+  std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * size));
+  std::pair<Map<int, int>, Map<int, int>> maps;
+  for (int64_t i = 0; i < size; ++i) {
+    maps.first[dist(mt)] = 1;
+    maps.second[dist(mt)] = 2;
+  }
+  return maps;
+}
+
+enum class Combination { Steal, Copy, InsertLoop };
+
+template <Combination How>
+void BM_CustomMapUnion(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto [a, b] = OverlappingMaps(state.range(0));
+    state.ResumeTiming();
+    if constexpr (How == Combination::Steal) {
+      a.MergeFrom(std::move(b));
+    } else if constexpr (How == Combination::Copy) {
+      a = Map<int, int>::Union(a, b);
+    } else {
+      b.ForEach([&a](int key, int value) { a[key] = value; });
+    }
+    benchmark::DoNotOptimize(a);
+    state.PauseTiming();
+    a.Clear();
+    b.Clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+template <Combination How>
+void BM_CustomMapIntersection(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto [a, b] = OverlappingMaps(state.range(0));
+    state.ResumeTiming();
+    Map<int, int> result;
+    if constexpr (How == Combination::Steal) {
+      result = Map<int, int>::Intersection(std::move(a), std::move(b));
+    } else if constexpr (How == Combination::Copy) {
+      result = Map<int, int>::Intersection(a, b);
+    } else {
+      a.ForEach([&b, &result](int key, int value) {
+        if (b.Find(key)) {
+          result[key] = value;
+        }
+      });
+    }
+    benchmark::DoNotOptimize(result);
+    state.PauseTiming();
+    result.Clear();
+    a.Clear();
+    b.Clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
 
 BENCHMARK(BM_CustomMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
-BENCHMARK(BM_CustomMapLinearInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
-BENCHMARK(BM_StdMapLinearInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapLinearInsert)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdMapLinearInsert)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
-BENCHMARK(BM_CustomMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapClear, HeapNodeStorage)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapClear, ArenaNodeStorage)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_BTreeMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BTreeMapLinearInsert)->Range(1<<10, 1<<22)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BTreeMapFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdMapFind)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BTreeMapValues)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapValues)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdMapValues)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BTreeMapForEach)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapForEach)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapAscending)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_CustomMapInsertLoad, HeapNodeStorage)->ArgsProduct({{1<<10, 1<<15, 1<<20}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapInsertLoad, ArenaNodeStorage)->ArgsProduct({{1<<10, 1<<15, 1<<20}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapBulkLoad, HeapNodeStorage)->ArgsProduct({{1<<10, 1<<15, 1<<20}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapBulkLoad, ArenaNodeStorage)->ArgsProduct({{1<<10, 1<<15, 1<<20}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_OrderStatisticMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OrderStatisticMapSelect)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_CustomMapValuesSelect)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_OrderStatisticMapCountRange)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK(BM_CustomMapValuesCountRange)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK_TEMPLATE(BM_StringMapViewLookup, std::less<CountedString>)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK_TEMPLATE(BM_StringMapViewLookup, std::less<>)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK_TEMPLATE(BM_CustomMapCheckedLookup, false)->Range(1<<10, 1<<20)->Complexity();
+BENCHMARK_TEMPLATE(BM_CustomMapCheckedLookup, true)->Range(1<<10, 1<<20)->Complexity();
+
+BENCHMARK(BM_ConcurrentMapMixed)->Arg(50)->Arg(90)->Arg(99)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_LockedMapMixed)->Arg(50)->Arg(90)->Arg(99)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_SkipListMapMixed)->Arg(0)->Arg(50)->Arg(90)->Arg(99)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(BM_PersistentMapVersion)->ArgsProduct({{1<<16, 1<<20}, {1, 16}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CustomMapCopyVersion)->ArgsProduct({{1<<16, 1<<20}, {1, 16}})->Unit(benchmark::kMicrosecond);
+
+// 16K keys fit in L2, 4M keys of Map or std::map nodes outgrow a typical LLC
+BENCHMARK(BM_FrozenMapLookup)->RangeMultiplier(4)->Range(1<<14, 1<<22);
+BENCHMARK(BM_CustomMapLookup)->RangeMultiplier(4)->Range(1<<14, 1<<22);
+BENCHMARK(BM_StdMapLookup)->RangeMultiplier(4)->Range(1<<14, 1<<22);
+
+BENCHMARK(BM_ArtMapLookup)->RangeMultiplier(4)->Range(1<<14, 1<<22);
+BENCHMARK_TEMPLATE(BM_PathMapInsert, ArtMap<std::string, int>)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PathMapInsert, Map<std::string, int>)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PathMapInsert, std::map<std::string, int>)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PathMapLookup, ArtMap<std::string, int>)->Range(1<<10, 1<<20);
+BENCHMARK_TEMPLATE(BM_PathMapLookup, Map<std::string, int>)->Range(1<<10, 1<<20);
+BENCHMARK_TEMPLATE(BM_PathMapLookup, std::map<std::string, int>)->Range(1<<10, 1<<20);
+
+BENCHMARK_TEMPLATE(BM_CustomMapUnion, Combination::Steal)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapUnion, Combination::Copy)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapUnion, Combination::InsertLoop)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapIntersection, Combination::Steal)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapIntersection, Combination::Copy)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CustomMapIntersection, Combination::InsertLoop)->Range(1<<10, 1<<20)->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
\ No newline at end of file
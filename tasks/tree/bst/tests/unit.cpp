@@ -1,14 +1,29 @@
 #include <chrono>
 #include <future>
 #include <map>
+#include <limits>
+#include <atomic>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <random>
+#include <stdexcept>
 #include <iostream>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
 
+#include "../art_map.hpp"
+#include "../btree_map.hpp"
+#include "../concurrent_map.hpp"
 #include "../map.hpp"
+#include "../persistent_map.hpp"
+#include "../skip_list_map.hpp"
 
 class MapTest: public testing::Test {
   protected:
@@ -293,6 +308,13 @@ TEST_F(MapTest, EraseNotExistingValue) {
   });
 }
 
+TEST_F(MapTest, TryErase) {
+  ASSERT_FALSE(mp.TryErase(-100));
+  ASSERT_TRUE(mp.TryErase(3));
+  ASSERT_FALSE(mp.Find(3));
+  ASSERT_FALSE(mp.TryErase(3));
+}
+
 TEST_F(MapTest, CustomComparator) {
   struct Point {
     int x;
@@ -335,6 +357,1052 @@ TEST_F(MapTest, CustomComparator) {
 
 }
 
+TEST(EmptyMapTest, SortedInsertAndErase) {
+  const int size = 1 << 16;
+  Map<int, std::string> mp;
+  for (int i = 0; i < size; ++i) {
+    mp[i] = std::to_string(i);
+  }
+  for (int i = size; i-- > 0;) {
+    mp.Insert({i + size, std::to_string(i)});
+  }
+  ASSERT_EQ(mp.Size(), 2 * size);
+  for (int i = 0; i < size; i += 2) {
+    mp.Erase(i);
+    mp.Erase(i + size + 1);
+  }
+  ASSERT_EQ(mp.Size(), size);
+  auto values = mp.Values();
+  for (int i = 0; i < size / 2; ++i) {
+    ASSERT_EQ(values[i].first, 2 * i + 1);
+    ASSERT_EQ(values[i].second, std::to_string(2 * i + 1));
+    ASSERT_EQ(values[i + size / 2].first, size + 2 * i);
+  }
+}
+
+TEST(EmptyMapTest, RandomOperationsMatchStdMap) {
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> keys(0, 999);
+  Map<int, int> mp;
+  std::map<int, int> expected;
+  for (int i = 0; i < 20000; ++i) {
+    int key = keys(mt);
+    if (mt() % 3 == 0) {
+      ASSERT_EQ(mp.Find(key), expected.count(key) == 1);
+      if (expected.erase(key) == 1) {
+        mp.Erase(key);
+      } else {
+        ASSERT_THROW(mp.Erase(key), MapIsEmptyException);
+      }
+    } else {
+      mp[key] += i;
+      expected[key] += i;
+    }
+    ASSERT_EQ(mp.Size(), expected.size());
+  }
+  auto values = mp.Values();
+  auto it = values.begin();
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(it->first, key);
+    ASSERT_EQ(it->second, value);
+    ++it;
+  }
+}
+
+TEST(BTreeMapTest, MapInterface) {
+  BTreeMap<int, int> mp;
+  ASSERT_TRUE(mp.IsEmpty());
+  ASSERT_FALSE(mp.Find(1));
+  ASSERT_THROW(mp.Erase(1), MapIsEmptyException);
+  mp.Insert({{1, 5}, {3, 10}, {5, 90}, {10, -10}, {90, 0}, {-10, 5}, {0, 4}});
+  ASSERT_EQ(mp.Size(), 7);
+  ASSERT_EQ(mp[5], 90);
+  mp[5] = 91;
+  mp.Insert({3, 11});
+  ASSERT_EQ(mp[3], 11);
+  ASSERT_EQ(mp[7], 0);
+  ASSERT_EQ(mp.Size(), 8);
+  mp.Erase(7);
+  ASSERT_FALSE(mp.Find(7));
+  std::vector<int> keys;
+  for (const auto& [key, value] : mp.Values(false)) {
+    keys.push_back(key);
+  }
+  ASSERT_EQ(keys, (std::vector<int>{90, 10, 5, 3, 1, 0, -10}));
+  auto range = mp.Range(0, 10);
+  ASSERT_EQ(range.size(), 4);
+  ASSERT_EQ(range.front().first, 0);
+  ASSERT_EQ(range.back().first, 5);
+  BTreeMap<int, int> other;
+  std::swap(mp, other);
+  ASSERT_TRUE(mp.IsEmpty());
+  ASSERT_EQ(other.Size(), 7);
+  other.Clear();
+  ASSERT_TRUE(other.IsEmpty());
+}
+
+TEST(BTreeMapTest, SortedInsertAndErase) {
+  const int size = 1 << 16;
+  BTreeMap<int, int> mp;
+  for (int i = 0; i < size; ++i) {
+    mp[i] = i;
+  }
+  for (int i = 2 * size; i-- > size;) {
+    mp.Insert({i, i});
+  }
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), 2 * size);
+  for (int i = 0; i < 2 * size; ++i) {
+    ASSERT_EQ(values[i].first, i);
+  }
+  for (int i = 0; i < 2 * size; ++i) {
+    mp.Erase(i);
+  }
+  ASSERT_TRUE(mp.IsEmpty());
+  ASSERT_TRUE(mp.Values().empty());
+}
+
+// Nodes default construct their key slots, so this makes allocating a node fail
+struct FailingKey {
+  static inline bool fail_construction = false;
+  int value = 0;
+
+  FailingKey() {
+    if (fail_construction) {
+      throw std::runtime_error("Key construction failed");
+    }
+  }
+
+  FailingKey(int v) : value(v) {
+  }
+
+  bool operator<(const FailingKey& other) const {
+    return value < other.value;
+  }
+};
+
+TEST(BTreeMapTest, FailedSplitLeavesTreeUnchanged) {
+  const int size = 1000;
+  BTreeMap<FailingKey, int> mp;
+  for (int key = 0; key < size; key += 2) {
+    mp[key] = key;
+  }
+  FailingKey::fail_construction = true;
+  std::vector<int> failed;
+  size_t expected_size = mp.Size();
+  for (int key = 1; key < size; key += 2) {
+    try {
+      mp[key] = key;
+      ++expected_size;
+    } catch (const std::runtime_error&) {
+      failed.push_back(key);
+      ASSERT_FALSE(mp.Find(key));
+    }
+    ASSERT_EQ(mp.Size(), expected_size);
+  }
+  FailingKey::fail_construction = false;
+  ASSERT_FALSE(failed.empty());
+  for (int key : failed) {
+    mp[key] = key;
+  }
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), size);
+  for (int key = 0; key < size; ++key) {
+    ASSERT_EQ(values[key].first.value, key);
+    ASSERT_EQ(values[key].second, key);
+  }
+}
+
+TEST(BTreeMapTest, RandomOperationsMatchStdMap) {
+  // Large entries make narrow nodes, so splits and merges reach several levels
+  using Payload = std::array<int, 32>;
+  std::mt19937 mt(7);
+  std::uniform_int_distribution<int> keys(0, 4999);
+  BTreeMap<std::string, Payload> mp;
+  std::map<std::string, Payload> expected;
+  for (int i = 0; i < 60000; ++i) {
+    std::string key = std::to_string(keys(mt));
+    if (mt() % 2 == 0) {
+      ASSERT_EQ(mp.Find(key), expected.count(key) == 1);
+      if (expected.erase(key) == 1) {
+        mp.Erase(key);
+      } else {
+        ASSERT_THROW(mp.Erase(key), MapIsEmptyException);
+      }
+    } else {
+      mp[key][0] += i;
+      expected[key][0] += i;
+    }
+    ASSERT_EQ(mp.Size(), expected.size());
+  }
+  auto values = mp.Values();
+  auto it = values.begin();
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(it->first, key);
+    ASSERT_EQ(it->second[0], value[0]);
+    ++it;
+  }
+  auto range = mp.Range("2", "3");
+  ASSERT_EQ(range.size(), std::distance(expected.lower_bound("2"), expected.lower_bound("3")));
+}
+
+TEST(ArenaMapTest, RandomOperationsMatchStdMap) {
+  std::mt19937 mt(11);
+  std::uniform_int_distribution<int> keys(0, 999);
+  Map<int, int, std::less<int>, ArenaNodeStorage> mp;
+  std::map<int, int> expected;
+  for (int i = 0; i < 20000; ++i) {
+    int key = keys(mt);
+    if (mt() % 3 == 0) {
+      if (expected.erase(key) == 1) {
+        mp.Erase(key);
+      } else {
+        ASSERT_THROW(mp.Erase(key), MapIsEmptyException);
+      }
+    } else {
+      mp[key] += i;
+      expected[key] += i;
+    }
+    ASSERT_EQ(mp.Size(), expected.size());
+    if (i % 5000 == 4999) {
+      mp.Clear();
+      expected.clear();
+    }
+  }
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), expected.size());
+  auto it = values.begin();
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(it->first, key);
+    ASSERT_EQ(it->second, value);
+    ++it;
+  }
+}
+
+TEST(ArenaMapTest, NonTrivialValuesAndSwap) {
+  Map<std::string, std::string, std::less<std::string>, ArenaNodeStorage> first;
+  Map<std::string, std::string, std::less<std::string>, ArenaNodeStorage> second;
+  for (int i = 0; i < 1000; ++i) {
+    first[std::to_string(i)] = std::string(40, 'a' + i % 26);
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    first.Erase(std::to_string(i));
+  }
+  second["key"] = "value";
+  std::swap(first, second);
+  ASSERT_EQ(first.Size(), 1);
+  ASSERT_EQ(first["key"], "value");
+  ASSERT_EQ(second.Size(), 500);
+  ASSERT_EQ(second["999"], std::string(40, 'a' + 999 % 26));
+  second.Clear();
+  ASSERT_TRUE(second.IsEmpty());
+  second["again"] = std::string(100, 'x');
+  ASSERT_EQ(second.Size(), 1);
+}
+
+TEST(EmptyMapTest, OrderedViews) {
+  Map<int, int> mp;
+  ASSERT_TRUE(mp.Ascending().begin() == mp.Ascending().end());
+  std::mt19937 mt(3);
+  for (int i = 0; i < 5000; ++i) {
+    mp[static_cast<int>(mt() % 10000)] = i;
+  }
+  auto values = mp.Values();
+  size_t index = 0;
+  for (const auto& [key, value] : mp.Ascending()) {
+    ASSERT_EQ(key, values[index].first);
+    ASSERT_EQ(value, values[index].second);
+    ++index;
+  }
+  ASSERT_EQ(index, mp.Size());
+  for (const auto& [key, value] : mp.Descending()) {
+    --index;
+    ASSERT_EQ(key, values[index].first);
+    ASSERT_EQ(value, values[index].second);
+  }
+  mp.ForEach([](const int&, int& value) { value = -value; }, false);
+  index = 0;
+  mp.ForEach([&](const int& key, int& value) {
+    ASSERT_EQ(key, values[index].first);
+    ASSERT_EQ(value, -values[index].second);
+    ++index;
+  });
+  ASSERT_EQ(index, mp.Size());
+}
+
+TEST(ConstMapTest, HandsOutConstEntries) {
+  Map<int, int> mp;
+  mp[1] = 10;
+  const auto& view = std::as_const(mp);
+  static_assert(std::is_same_v<decltype(*view.Ascending().begin()), const std::pair<const int, int>&>);
+  static_assert(std::is_same_v<decltype(*mp.Descending().begin()), std::pair<const int, int>&>);
+  OrderStatisticMap<int, int> ranked;
+  static_assert(std::is_same_v<decltype(std::as_const(ranked).Select(0)), const std::pair<const int, int>&>);
+  static_assert(std::is_same_v<decltype(ranked.Select(0)), std::pair<const int, int>&>);
+  static_assert(std::is_same_v<decltype(view.FindPtr(1)), const int*>);
+  static_assert(std::is_same_v<decltype(mp.FindPtr(1)), int*>);
+  int sum = 0;
+  view.ForEach([&sum](const int& key, auto& value) {
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(value)>>);
+    sum += key + value;
+  });
+  ASSERT_EQ(sum, 11);
+}
+
+TEST(ConstMapTest, BTreeMapHandsOutConstValues) {
+  BTreeMap<int, int> mp;
+  mp[1] = 10;
+  int sum = 0;
+  std::as_const(mp).ForEach([&sum](const int& key, auto& value) {
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(value)>>);
+    sum += key + value;
+  });
+  ASSERT_EQ(sum, 11);
+}
+
+TEST(ConstMapTest, ArtMapHandsOutConstValues) {
+  ArtMap<int, int> mp;
+  mp[1] = 10;
+  static_assert(std::is_same_v<decltype(std::as_const(mp).FindPtr(1)), const int*>);
+  int sum = 0;
+  std::as_const(mp).ForEach([&sum](const int& key, auto& value) {
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(value)>>);
+    sum += key + value;
+  });
+  ASSERT_EQ(sum, 11);
+}
+
+TEST(BTreeMapTest, SwapExchangesComparators) {
+  // Ascending unless told otherwise, so keeping the old comparator would misorder the nodes
+  struct Directed {
+    bool descending = false;
+
+    bool operator()(int a, int b) const {
+      return descending ? b < a : a < b;
+    }
+  };
+  BTreeMap<int, int, Directed> ascending;
+  BTreeMap<int, int, Directed> descending(Directed{true});
+  for (int i = 0; i < 500; ++i) {
+    ascending[i] = i;
+    descending[i] = -i;
+  }
+  ascending.Swap(descending);
+  for (int i = 500; i < 1000; ++i) {
+    ascending[i] = -i;
+    descending[i] = i;
+  }
+  auto now_descending = ascending.Values();
+  auto now_ascending = descending.Values();
+  ASSERT_EQ(now_descending.size(), 1000);
+  ASSERT_EQ(now_ascending.size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(now_descending[i].first, 999 - i);
+    ASSERT_EQ(now_descending[i].second, i - 999);
+    ASSERT_EQ(now_ascending[i].first, i);
+    ASSERT_EQ(now_ascending[i].second, i);
+    ASSERT_TRUE(ascending.Find(i));
+  }
+}
+
+TEST(BTreeMapTest, ForEach) {
+  BTreeMap<int, int> mp;
+  for (int i = 0; i < 1000; ++i) {
+    mp[i * 7 % 1000] = i;
+  }
+  int expected = 999;
+  mp.ForEach([&expected](const int& key, int& value) {
+    ASSERT_EQ(key, expected--);
+    value = key;
+  }, false);
+  ASSERT_EQ(expected, -1);
+  auto values = mp.Values();
+  for (const auto& [key, value] : values) {
+    ASSERT_EQ(key, value);
+  }
+}
+
+TEST(EmptyMapTest, FromSorted) {
+  std::vector<std::pair<int, int>> sorted;
+  for (int i = 0; i < 1000; ++i) {
+    sorted.emplace_back(i / 2, i);
+  }
+  auto mp = Map<int, int>::FromSorted(sorted);
+  ASSERT_EQ(mp.Size(), 500);
+  int expected = 0;
+  for (const auto& [key, value] : mp.Ascending()) {
+    ASSERT_EQ(key, expected);
+    ASSERT_EQ(value, expected * 2 + 1);
+    ++expected;
+  }
+  mp[1000] = 1;
+  for (int i = 0; i < 500; i += 3) {
+    mp.Erase(i);
+  }
+  ASSERT_EQ(mp.Size(), 334);
+  auto empty = Map<int, int>::FromSorted(std::vector<std::pair<int, int>>());
+  ASSERT_TRUE(empty.IsEmpty());
+}
+
+TEST(EmptyMapTest, FromUnsortedUsesTheGivenComparator) {
+  // Ascending unless told otherwise, so a default constructed comparator would disagree
+  struct Directed {
+    bool descending = false;
+
+    bool operator()(int a, int b) const {
+      return descending ? b < a : a < b;
+    }
+  };
+  std::vector<std::pair<int, int>> entries;
+  for (int i = 0; i < 100; ++i) {
+    entries.emplace_back(i * 37 % 100, i);
+  }
+  auto mp = Map<int, int, Directed>::FromUnsorted(entries, Directed{true});
+  int expected = 99;
+  for (const auto& [key, value] : mp.Ascending()) {
+    ASSERT_EQ(key, expected--);
+  }
+  ASSERT_EQ(expected, -1);
+  mp[-1] = 0;
+  ASSERT_EQ(mp.Values().back().first, -1);
+}
+
+TEST(ArenaMapTest, FromUnsortedMatchesStdMap) {
+  std::mt19937 mt(17);
+  std::vector<std::pair<std::string, int>> entries;
+  std::map<std::string, int> expected;
+  for (int i = 0; i < 20000; ++i) {
+    std::string key = std::to_string(mt() % 5000);
+    entries.emplace_back(key, i);
+    expected[key] = i;
+  }
+  auto mp = Map<std::string, int, std::less<std::string>, ArenaNodeStorage>::FromUnsorted(entries);
+  ASSERT_EQ(mp.Size(), expected.size());
+  auto it = expected.begin();
+  for (const auto& [key, value] : mp.Ascending()) {
+    ASSERT_EQ(key, it->first);
+    ASSERT_EQ(value, it->second);
+    ++it;
+  }
+  for (int i = 0; i < 5000; i += 2) {
+    std::string key = std::to_string(i);
+    if (expected.erase(key) == 1) {
+      mp.Erase(key);
+    }
+    mp[key + "x"] = i;
+  }
+  ASSERT_EQ(mp.Size(), expected.size() + 2500);
+  Map<std::string, int, std::less<std::string>, ArenaNodeStorage> moved;
+  moved = std::move(mp);
+  ASSERT_TRUE(mp.IsEmpty());
+  ASSERT_EQ(moved.Size(), expected.size() + 2500);
+}
+
+TEST(OrderStatisticMapTest, MatchesSortedKeys) {
+  std::mt19937 mt(23);
+  std::uniform_int_distribution<int> keys(0, 1999);
+  OrderStatisticMap<int, int> mp;
+  std::map<int, int> expected;
+  ASSERT_THROW(mp.Select(0), std::out_of_range);
+  for (int i = 0; i < 20000; ++i) {
+    int key = keys(mt);
+    int op = static_cast<int>(mt() % 4);
+    if (op == 0 && expected.count(key) == 1) {
+      mp.Erase(key);
+      expected.erase(key);
+    } else if (op == 1 && !expected.empty()) {
+      size_t k = mt() % expected.size();
+      auto it = std::next(expected.begin(), static_cast<std::ptrdiff_t>(k));
+      ASSERT_EQ(mp.Select(k).first, it->first);
+      mp.EraseAt(k);
+      expected.erase(it);
+    } else {
+      mp[key] = i;
+      expected[key] = i;
+    }
+    ASSERT_EQ(mp.Size(), expected.size());
+    if (i % 97 == 0) {
+      size_t k = 0;
+      for (const auto& [key, value] : expected) {
+        ASSERT_EQ(mp.Select(k).first, key);
+        ASSERT_EQ(mp.Select(k).second, value);
+        ASSERT_EQ(mp.Rank(key), k);
+        ++k;
+      }
+      int lo = keys(mt);
+      int hi = keys(mt);
+      auto count = lo < hi ? std::distance(expected.lower_bound(lo), expected.lower_bound(hi)) : 0;
+      ASSERT_EQ(mp.CountRange(lo, hi), static_cast<size_t>(count));
+    }
+  }
+  ASSERT_THROW(mp.EraseAt(mp.Size()), std::out_of_range);
+}
+
+TEST(OrderStatisticMapTest, FromSorted) {
+  std::vector<std::pair<int, int>> sorted;
+  for (int i = 0; i < 1000; ++i) {
+    sorted.emplace_back(i * 2, i);
+  }
+  auto mp = OrderStatisticMap<int, int>::FromSorted(sorted);
+  ASSERT_EQ(mp.Select(500).first, 1000);
+  ASSERT_EQ(mp.Rank(1001), 501);
+  ASSERT_EQ(mp.CountRange(10, 20), 5);
+  mp.EraseAt(0);
+  ASSERT_EQ(mp.Select(0).first, 2);
+  ASSERT_EQ(mp.Rank(1001), 500);
+}
+
+TEST(EmptyMapTest, TransparentLookup) {
+  Map<std::string, int, std::less<>> mp;
+  std::string_view first = "first key that does not fit into a small string";
+  mp[first] = 1;
+  mp["second"] = 2;
+  mp.Insert({"third", 3});
+  ASSERT_EQ(mp.Size(), 3);
+  ASSERT_TRUE(mp.Find(first));
+  ASSERT_TRUE(mp.Find("second"));
+  ASSERT_FALSE(mp.Find(std::string_view("fourth")));
+  ASSERT_EQ(mp[first.substr(0)], 1);
+  mp.Erase(std::string_view("second"));
+  ASSERT_THROW(mp.Erase("second"), MapIsEmptyException);
+  mp.Erase(std::string(first));
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), 1);
+  ASSERT_EQ(values[0].first, "third");
+}
+
+TEST(EmptyMapTest, SingleDescentLookups) {
+  Map<std::string, std::string, std::less<>> mp;
+  ASSERT_EQ(mp.FindPtr("a"), nullptr);
+  auto [value, inserted] = mp.TryEmplace("a", 3, 'x');
+  ASSERT_TRUE(inserted);
+  ASSERT_EQ(*value, "xxx");
+  auto [same, inserted_again] = mp.TryEmplace(std::string_view("a"), 5, 'y');
+  ASSERT_FALSE(inserted_again);
+  ASSERT_EQ(same, value);
+  ASSERT_EQ(*same, "xxx");
+  ASSERT_TRUE(mp.InsertOrAssign("b", "first"));
+  ASSERT_FALSE(mp.InsertOrAssign("b", std::string("second")));
+  ASSERT_EQ(*mp.FindPtr(std::string_view("b")), "second");
+  *mp.FindPtr("a") = "changed";
+  ASSERT_EQ(mp["a"], "changed");
+  ASSERT_EQ(mp.Size(), 2);
+}
+
+TEST(ConcurrentMapTest, MapInterface) {
+  ConcurrentMap<int, std::string> mp(5);
+  ASSERT_EQ(mp.ShardCount(), 8);
+  ASSERT_TRUE(mp.IsEmpty());
+  ASSERT_TRUE(mp.Insert(1, "one"));
+  ASSERT_FALSE(mp.Insert(1, "uno"));
+  ASSERT_EQ(mp.TryGet(1), "one");
+  ASSERT_FALSE(mp.InsertOrAssign(1, "uno"));
+  ASSERT_EQ(mp.TryGet(1), "uno");
+  ASSERT_EQ(mp.TryGet(2), std::nullopt);
+  mp.Update(2, [](std::string& value) { value += "two"; });
+  ASSERT_TRUE(mp.Contains(2));
+  ASSERT_EQ(mp.Size(), 2);
+  ASSERT_TRUE(mp.Erase(1));
+  ASSERT_FALSE(mp.Erase(1));
+  ASSERT_FALSE(mp.Contains(1));
+  mp.Clear();
+  ASSERT_TRUE(mp.IsEmpty());
+  ASSERT_TRUE(mp.Values().empty());
+}
+
+TEST(ConcurrentMapTest, OrderedMergeOfShards) {
+  ConcurrentMap<int, int> mp(16);
+  std::map<int, int> expected;
+  std::mt19937 gen(45);
+  std::uniform_int_distribution<int> dist(-10000, 10000);
+  for (int i = 0; i < 5000; ++i) {
+    int key = dist(gen);
+    mp.InsertOrAssign(key, i);
+    expected[key] = i;
+  }
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), expected.size());
+  size_t index = 0;
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(values[index].first, key);
+    ASSERT_EQ(values[index].second, value);
+    ++index;
+  }
+  auto descending = mp.Values(false);
+  ASSERT_EQ(descending.front().first, expected.rbegin()->first);
+  ASSERT_EQ(descending.back().first, expected.begin()->first);
+}
+
+TEST(ConcurrentMapTest, ShardsUseTheGivenComparator) {
+  // Ascending unless told otherwise, so default constructed shards would disagree
+  struct Directed {
+    bool descending = false;
+
+    bool operator()(int a, int b) const {
+      return descending ? b < a : a < b;
+    }
+  };
+  ConcurrentMap<int, int, Directed> mp(4, Directed{true});
+  for (int key = 0; key < 100; ++key) {
+    mp.Insert(key, key);
+  }
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), 100);
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i].first, 99 - static_cast<int>(i));
+  }
+}
+
+TEST(ConcurrentMapTest, ParallelInsertsAndLookups) {
+  constexpr int ThreadCount = 4;
+  constexpr int PerThread = 2000;
+  ConcurrentMap<int, int> mp;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < ThreadCount; ++t) {
+    threads.emplace_back([&mp, t] {
+      for (int i = 0; i < PerThread; ++i) {
+        int key = i * ThreadCount + t;
+        mp.Insert(key, key);
+        mp.Update(-1, [](int& counter) { ++counter; });
+        mp.Contains(key - 1);
+        if (i % 2 == 1) {
+          mp.Erase(key);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(mp.TryGet(-1), ThreadCount * PerThread);
+  ASSERT_EQ(mp.Size(), ThreadCount * PerThread / 2 + 1);
+  int previous = -2;
+  mp.ForEach([&previous](const int& key, const int& value) {
+    ASSERT_LT(previous, key);
+    ASSERT_TRUE(key == -1 || key == value);
+    previous = key;
+  });
+}
+
+TEST(PersistentMapTest, VersionsAreIndependent) {
+  PersistentMap<int, std::string> empty;
+  auto first = empty.Insert(2, "two").Insert(1, "one");
+  auto second = first.Insert(3, "three");
+  auto third = second.Insert(1, "uno").Erase(2);
+  ASSERT_TRUE(empty.IsEmpty());
+  ASSERT_EQ(first.Size(), 2);
+  ASSERT_FALSE(first.Find(3));
+  ASSERT_EQ(second.Size(), 3);
+  ASSERT_EQ(*second.FindPtr(1), "one");
+  ASSERT_EQ(third.Size(), 2);
+  ASSERT_EQ(*third.FindPtr(1), "uno");
+  ASSERT_EQ(third.FindPtr(2), nullptr);
+  ASSERT_THROW(third.Erase(2), MapIsEmptyException);
+  PersistentMap<int, std::string> snapshot = second;
+  second = empty;
+  ASSERT_EQ(snapshot.Size(), 3);
+  auto values = snapshot.Values(false);
+  ASSERT_EQ(values[0].first, 3);
+  ASSERT_EQ(values[2].second, "one");
+}
+
+TEST(PersistentMapTest, RandomVersionsMatchStdMap) {
+  std::vector<PersistentMap<int, int>> versions(1);
+  std::vector<std::map<int, int>> expected(1);
+  std::mt19937 gen(46);
+  std::uniform_int_distribution<int> dist(0, 300);
+  for (int i = 0; i < 2000; ++i) {
+    int key = dist(gen);
+    const auto& last = versions.back();
+    std::map<int, int> next = expected.back();
+    if (i % 3 == 2 && last.Find(key)) {
+      versions.push_back(last.Erase(key));
+      next.erase(key);
+    } else {
+      versions.push_back(last.Insert(key, i));
+      next[key] = i;
+    }
+    expected.push_back(std::move(next));
+  }
+  for (size_t version = 0; version < versions.size(); version += 97) {
+    auto values = versions[version].Values();
+    ASSERT_EQ(values.size(), expected[version].size());
+    size_t index = 0;
+    for (const auto& [key, value] : expected[version]) {
+      ASSERT_EQ(values[index].first, key);
+      ASSERT_EQ(values[index].second, value);
+      ++index;
+    }
+  }
+}
+
+TEST(PersistentMapTest, FromSorted) {
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < 1000; ++i) {
+    pairs.emplace_back(i / 2, i);
+  }
+  auto mp = PersistentMap<int, int>::FromSorted(pairs);
+  ASSERT_EQ(mp.Size(), 500);
+  ASSERT_EQ(*mp.FindPtr(10), 21);
+  auto changed = mp.Erase(10).Insert(1000, 0);
+  ASSERT_EQ(mp.Size(), 500);
+  ASSERT_EQ(changed.Size(), 500);
+  ASSERT_FALSE(changed.Find(10));
+}
+
+TEST(SkipListMapTest, MatchesStdMap) {
+  SkipListMap<int, int> mp;
+  std::map<int, int> expected;
+  std::mt19937 gen(47);
+  std::uniform_int_distribution<int> dist(0, 500);
+  for (int i = 0; i < 5000; ++i) {
+    int key = dist(gen);
+    if (i % 3 == 0) {
+      ASSERT_EQ(mp.Erase(key), expected.erase(key) == 1);
+    } else {
+      ASSERT_EQ(mp.Insert(key, i), expected.emplace(key, i).second);
+    }
+  }
+  ASSERT_EQ(mp.Size(), expected.size());
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), expected.size());
+  size_t index = 0;
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(values[index].first, key);
+    ASSERT_EQ(values[index].second, value);
+    ASSERT_TRUE(mp.Contains(key));
+    ASSERT_EQ(mp.TryGet(key), value);
+    ++index;
+  }
+  ASSERT_EQ(mp.TryGet(-1), std::nullopt);
+  auto view = mp.LowerBound(250);
+  auto it = view.begin();
+  ASSERT_EQ(it->first, expected.lower_bound(250)->first);
+  int previous = -1;
+  for (; it != view.end(); ++it) {
+    ASSERT_LT(previous, it->first);
+    previous = it->first;
+    // Updates while a view is held by the same thread
+    mp.Erase(it->first);
+  }
+  ASSERT_EQ(previous, expected.rbegin()->first);
+  ASSERT_FALSE(mp.Contains(previous));
+  ASSERT_EQ(mp.LowerBound(250).begin(), mp.LowerBound(250).end());
+}
+
+TEST(SkipListMapTest, DuplicateInsertKeepsOldValue) {
+  SkipListMap<std::string, int> mp;
+  ASSERT_TRUE(mp.Insert("a", 1));
+  ASSERT_FALSE(mp.Insert("a", 2));
+  ASSERT_EQ(mp.Size(), 1);
+  ASSERT_EQ(mp.TryGet("a"), 1);
+}
+
+TEST(SkipListMapTest, ConcurrentUpdatesAndScans) {
+  constexpr int ThreadCount = 4;
+  constexpr int KeyCount = 4000;
+  SkipListMap<int, int> mp;
+  std::atomic<bool> stop = false;
+  std::thread scanner([&mp, &stop] {
+    while (!stop.load()) {
+      int previous = -1;
+      for (const auto& [key, value] : mp.Ascending()) {
+        ASSERT_LT(previous, key);
+        ASSERT_EQ(key, value);
+        previous = key;
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int t = 0; t < ThreadCount; ++t) {
+    writers.emplace_back([&mp, t] {
+      for (int round = 0; round < 3; ++round) {
+        for (int key = t; key < KeyCount; key += ThreadCount) {
+          mp.Insert(key, key);
+        }
+        for (int key = t; key < KeyCount; key += 2 * ThreadCount) {
+          mp.Erase(key);
+        }
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  stop = true;
+  scanner.join();
+  ASSERT_EQ(mp.Size(), KeyCount / 2);
+  for (int key = 0; key < KeyCount; ++key) {
+    ASSERT_EQ(mp.Contains(key), key % (2 * ThreadCount) >= ThreadCount);
+  }
+}
+
+TEST(FrozenMapTest, FreezeMatchesMap) {
+  for (int size : {0, 1, 2, 7, 8, 100, 1023, 1024, 5000}) {
+    Map<int, int> mp;
+    std::mt19937 gen(size);
+    std::uniform_int_distribution<int> dist(-3 * size, 3 * size);
+    for (int i = 0; i < size; ++i) {
+      mp[dist(gen)] = i;
+    }
+    auto frozen = mp.Freeze();
+    ASSERT_EQ(frozen.Size(), mp.Size());
+    for (int key = -3 * size - 1; key <= 3 * size + 1; ++key) {
+      int* value = mp.FindPtr(key);
+      const int* frozen_value = frozen.FindPtr(key);
+      ASSERT_EQ(frozen.Find(key), value != nullptr);
+      if (value != nullptr) {
+        ASSERT_EQ(*frozen_value, *value);
+      } else {
+        ASSERT_EQ(frozen_value, nullptr);
+      }
+    }
+    auto values = frozen.Values();
+    auto expected = mp.Values();
+    ASSERT_EQ(values.size(), expected.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(values[i].first, expected[i].first);
+      ASSERT_EQ(values[i].second, expected[i].second);
+    }
+    if (!values.empty()) {
+      ASSERT_EQ(frozen.Values(false).front().first, expected.back().first);
+    }
+  }
+}
+
+TEST(FrozenMapTest, TransparentStringKeys) {
+  Map<std::string, int, std::less<>> mp;
+  mp["beta"] = 2;
+  mp["alpha"] = 1;
+  mp["gamma"] = 3;
+  auto frozen = mp.Freeze();
+  mp["delta"] = 4;
+  ASSERT_EQ(frozen.Size(), 3);
+  ASSERT_EQ(*frozen.FindPtr(std::string_view("gamma")), 3);
+  ASSERT_FALSE(frozen.Find("delta"));
+  FrozenMap<std::string, int, std::less<>> other;
+  std::swap(frozen, other);
+  ASSERT_TRUE(frozen.IsEmpty());
+  ASSERT_TRUE(other.Find("alpha"));
+}
+
+TEST(ArtMapTest, IntegersMatchStdMap) {
+  ArtMap<int64_t, int> mp;
+  std::map<int64_t, int> expected;
+  std::mt19937 gen(49);
+  // Dense keys fill node256s, then erasing shrinks them back through every node type
+  std::uniform_int_distribution<int64_t> dist(-1500, 1500);
+  for (int i = 0; i < 20000; ++i) {
+    int64_t key = dist(gen);
+    if (i % 3 == 0 || (i > 10000 && i % 3 == 1)) {
+      bool present = expected.erase(key) == 1;
+      if (present) {
+        mp.Erase(key);
+      } else {
+        ASSERT_THROW(mp.Erase(key), MapIsEmptyException);
+      }
+    } else {
+      ASSERT_EQ(mp.InsertOrAssign(key, i), expected.insert_or_assign(key, i).second);
+    }
+    ASSERT_EQ(mp.Size(), expected.size());
+  }
+  mp[std::numeric_limits<int64_t>::min()] = 1;
+  mp[std::numeric_limits<int64_t>::max()] = 2;
+  expected[std::numeric_limits<int64_t>::min()] = 1;
+  expected[std::numeric_limits<int64_t>::max()] = 2;
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), expected.size());
+  size_t index = 0;
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(values[index].first, key);
+    ASSERT_EQ(values[index].second, value);
+    ASSERT_EQ(*mp.FindPtr(key), value);
+    ++index;
+  }
+  auto reversed = mp.Values(false);
+  ASSERT_EQ(reversed.front().first, std::numeric_limits<int64_t>::max());
+  ASSERT_EQ(reversed.back().first, std::numeric_limits<int64_t>::min());
+  for (int64_t key = -1600; key <= 1600; ++key) {
+    ASSERT_EQ(mp.Find(key), expected.contains(key));
+  }
+}
+
+TEST(ArtMapTest, StringKeysWithSharedPrefixes) {
+  ArtMap<std::string, int> mp;
+  std::map<std::string, int> expected;
+  std::vector<std::string> keys = {"", "/", "/usr", "/usr/bin", "/usr/bin/env", "/usr/lib", "/usr/lib64",
+                                   "/usr/local/bin", "/usr/local/lib", "/var/log", "/var/log/syslog", "a",
+                                   "ab", "abc", std::string("a\0b", 3), "\xff", "\x80/x"};
+  for (int dir = 0; dir < 40; ++dir) {
+    for (int file = 0; file < 20; ++file) {
+      keys.push_back(fmt::format("/home/user/project/src/module_{}/file_{}.cpp", dir, file));
+    }
+  }
+  std::mt19937 gen(7);
+  std::shuffle(keys.begin(), keys.end(), gen);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_TRUE(mp.TryEmplace(keys[i], static_cast<int>(i)).second);
+    expected[keys[i]] = static_cast<int>(i);
+  }
+  ASSERT_FALSE(mp.TryEmplace("/usr", -1).second);
+  ASSERT_EQ(mp.Size(), expected.size());
+  ASSERT_TRUE(mp.Find("/usr/lib"));
+  ASSERT_FALSE(mp.Find("/usr/li"));
+  ASSERT_FALSE(mp.Find("/usr/lib6"));
+  ASSERT_FALSE(mp.Find("/usr/local"));
+  ASSERT_EQ(mp.FindPtr(std::string_view("abcd")), nullptr);
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    mp.Erase(keys[i]);
+    expected.erase(keys[i]);
+    ASSERT_FALSE(mp.Find(keys[i]));
+  }
+  ASSERT_THROW(mp.Erase(keys[0]), MapIsEmptyException);
+  auto values = mp.Values();
+  ASSERT_EQ(values.size(), expected.size());
+  size_t index = 0;
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(values[index].first, key);
+    ASSERT_EQ(values[index].second, value);
+    ++index;
+  }
+  ArtMap<std::string, int> other;
+  std::swap(mp, other);
+  ASSERT_TRUE(mp.IsEmpty());
+  for (size_t i = 1; i < keys.size(); i += 2) {
+    other.Erase(keys[i]);
+  }
+  ASSERT_TRUE(other.IsEmpty());
+  other["again"] = 1;
+  ASSERT_EQ(other.Values().front().first, "again");
+}
+
+template <typename MapType>
+void CheckSetOperations() {
+  std::mt19937 gen(50);
+  for (int size : {0, 1, 10, 1000}) {
+    std::uniform_int_distribution<int> dist(0, 2 * size);
+    std::map<int, int> first;
+    std::map<int, int> second;
+    for (int i = 0; i < size; ++i) {
+      first[dist(gen)] = i;
+      second[dist(gen)] = -i;
+    }
+    auto build = [](const std::map<int, int>& entries) {
+      MapType mp;
+      for (const auto& [key, value] : entries) {
+        mp[key] = value;
+      }
+      return mp;
+    };
+    std::map<int, int> united = second;
+    std::map<int, int> common;
+    std::map<int, int> difference;
+    for (const auto& [key, value] : first) {
+      united.emplace(key, value);
+      (second.contains(key) ? common : difference).emplace(key, value);
+    }
+    auto check = [](const MapType& mp, const std::map<int, int>& expected) {
+      auto values = mp.Values();
+      ASSERT_EQ(mp.Size(), expected.size());
+      ASSERT_EQ(values.size(), expected.size());
+      size_t index = 0;
+      for (const auto& [key, value] : expected) {
+        ASSERT_EQ(values[index].first, key);
+        ASSERT_EQ(values[index].second, value);
+        ++index;
+      }
+    };
+    MapType a = build(first);
+    MapType b = build(second);
+    check(MapType::Union(a, b), united);
+    check(MapType::Intersection(a, b), common);
+    check(MapType::Difference(a, b), difference);
+    check(a, first);
+    check(b, second);
+    check(MapType::Union(build(first), build(second)), united);
+    check(MapType::Intersection(build(first), build(second)), common);
+    check(MapType::Difference(build(first), build(second)), difference);
+    a.MergeFrom(std::move(b));
+    check(a, united);
+    ASSERT_TRUE(b.IsEmpty());
+    // The merged map keeps working with nodes from both inputs
+    for (const auto& [key, value] : second) {
+      a.Erase(key);
+    }
+    a[-1] = 1;
+    ASSERT_EQ(a.Size(), difference.size() + 1);
+  }
+}
+
+TEST(EmptyMapTest, SetOperations) {
+  CheckSetOperations<Map<int, int>>();
+  CheckSetOperations<Map<int, int, std::less<int>, ArenaNodeStorage>>();
+}
+
+template <typename Storage>
+void CheckThrowingUnionReleasesNodes() {
+  // Live values, so a node that leaks or is freed without its destructor shows up
+  static int live = 0;
+  struct Counted {
+    Counted(int) {
+      ++live;
+    }
+    Counted(const Counted&) {
+      ++live;
+    }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() {
+      --live;
+    }
+  };
+  // Throws on the call that brings the countdown to zero, never while it is zero
+  struct Throwing {
+    int* countdown;
+
+    bool operator()(int a, int b) const {
+      if (*countdown > 0 && --*countdown == 0) {
+        throw std::runtime_error("comparator");
+      }
+      return a < b;
+    }
+  };
+  using MapType = Map<int, Counted, Throwing, Storage>;
+  for (int throw_after : {1, 10, 100}) {
+    int countdown = 0;
+    MapType a(Throwing{&countdown});
+    MapType b(Throwing{&countdown});
+    for (int i = 0; i < 200; ++i) {
+      a.InsertOrAssign(2 * i, i);
+      b.InsertOrAssign(3 * i, i);
+    }
+    countdown = throw_after;
+    ASSERT_THROW(MapType::Union(std::move(a), std::move(b)), std::runtime_error);
+    ASSERT_EQ(live, 0);
+  }
+}
+
+TEST(EmptyMapTest, ThrowingComparatorInUnionReleasesNodes) {
+  CheckThrowingUnionReleasesNodes<HeapNodeStorage>();
+  CheckThrowingUnionReleasesNodes<ArenaNodeStorage>();
+}
+
+TEST(OrderStatisticMapTest, SetOperations) {
+  OrderStatisticMap<int, int> evens;
+  OrderStatisticMap<int, int> thirds;
+  for (int i = 0; i < 3000; ++i) {
+    evens[2 * i] = i;
+    thirds[3 * i] = i;
+  }
+  auto united = OrderStatisticMap<int, int>::Union(std::move(evens), std::move(thirds));
+  ASSERT_TRUE(evens.IsEmpty());
+  ASSERT_EQ(united.Size(), 3000 + 2000);
+  for (size_t k = 0; k < united.Size(); ++k) {
+    ASSERT_EQ(united.Rank(united.Select(k).first), k);
+  }
+  united.EraseAt(0);
+  ASSERT_EQ(united.Select(0).first, 2);
+}
+
 
 
 int main(int argc, char **argv) {
@@ -7,6 +7,7 @@
 #include <iterator>
 #include <memory>
 #include <stack>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -83,6 +84,86 @@ public:
         Node* current_;
     };
 
+    // Walks the threads in either direction, so no stack is needed.
+    // The IsConst walk hands out entries by const reference
+    template <bool IsConst>
+    class BasicOrderedIterator {
+    public:
+        // NOLINTNEXTLINE
+        using value_type = std::pair<const Key, Value>;
+        // NOLINTNEXTLINE
+        using reference_type = std::conditional_t<IsConst, const value_type&, value_type&>;
+        // NOLINTNEXTLINE
+        using pointer_type = std::conditional_t<IsConst, const value_type*, value_type*>;
+        // NOLINTNEXTLINE
+        using difference_type = std::ptrdiff_t;
+        // NOLINTNEXTLINE
+        using iterator_category = std::forward_iterator_tag;
+
+        inline bool operator==(const BasicOrderedIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        inline bool operator!=(const BasicOrderedIterator& other) const {
+            return current_ != other.current_;
+        }
+
+        inline reference_type operator*() const {
+            return current_->data_;
+        }
+
+        inline pointer_type operator->() const {
+            return &(current_->data_);
+        }
+
+        BasicOrderedIterator& operator++() {
+            current_ = ascending_ ? Next(current_) : Prev(current_);
+            return *this;
+        }
+
+        BasicOrderedIterator operator++(int) {
+            BasicOrderedIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+    private:
+        BasicOrderedIterator(Node* node, bool ascending) : current_(node), ascending_(ascending) {
+        }
+        friend class Map;
+        Node* current_;
+        bool ascending_;
+    };
+
+    using OrderedIterator = BasicOrderedIterator<false>;
+    using ConstOrderedIterator = BasicOrderedIterator<true>;
+
+    // Lazy view for range-based for loops, entries from first up to last are visited in place
+    template <bool IsConst>
+    class BasicOrderedView {
+    public:
+        // NOLINTNEXTLINE
+        BasicOrderedIterator<IsConst> begin() const {
+            return BasicOrderedIterator<IsConst>(first_, ascending_);
+        }
+
+        // NOLINTNEXTLINE
+        BasicOrderedIterator<IsConst> end() const {
+            return BasicOrderedIterator<IsConst>(last_, ascending_);
+        }
+
+    private:
+        BasicOrderedView(Node* first, Node* last, bool ascending) : first_(first), last_(last), ascending_(ascending) {
+        }
+        friend class Map;
+        Node* first_;
+        Node* last_;
+        bool ascending_;
+    };
+
+    using OrderedView = BasicOrderedView<false>;
+    using ConstOrderedView = BasicOrderedView<true>;
+
     inline MapIterator Begin() const noexcept {
         Node* current = root_;
         if (!current) {
@@ -160,22 +241,43 @@ public:
 
     std::vector<std::pair<const Key, Value>> Values(bool is_increase = true) const noexcept {
         std::vector<std::pair<const Key, Value>> result;
-        if (is_increase) {
-            for (auto it = Begin(); it != End(); ++it) {
-                result.push_back(*it);
-            }
-        } else {
-            std::vector<std::pair<const Key, Value>> temp;
-            for (auto it = Begin(); it != End(); ++it) {
-                temp.push_back(*it);
-            }
-            for (auto it = temp.rbegin(); it != temp.rend(); ++it) {
-                result.push_back(*it);
-            }
-        }
+        result.reserve(size_);
+        ForEach([&result](const Key& key, const Value& value) { result.emplace_back(key, value); }, is_increase);
         return result;
     }
 
+    OrderedView Ascending() noexcept {
+        return OrderedView(Edge(true), nullptr, true);
+    }
+
+    ConstOrderedView Ascending() const noexcept {
+        return ConstOrderedView(Edge(true), nullptr, true);
+    }
+
+    OrderedView Descending() noexcept {
+        return OrderedView(Edge(false), nullptr, false);
+    }
+
+    ConstOrderedView Descending() const noexcept {
+        return ConstOrderedView(Edge(false), nullptr, false);
+    }
+
+    // Calls visitor(key, value) for every entry in order without copying them,
+    // the value is mutable unless the map is const
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) {
+        for (auto& [key, value] : is_increase ? Ascending() : Descending()) {
+            visitor(key, value);
+        }
+    }
+
+    template <typename Visitor>
+    void ForEach(Visitor visitor, bool is_increase = true) const {
+        for (const auto& [key, value] : is_increase ? Ascending() : Descending()) {
+            visitor(key, value);
+        }
+    }
+
     void Insert(const std::pair<const Key, Value>& val) {
         (*this)[val.first] = val.second;
     }
@@ -280,12 +382,21 @@ public:
                 }
             } else {
                 if (succ->is_right_thread_) {
-                    succ_parent->left_ = succ->right_;
+                    // The predecessor of succ_parent is now current, which takes over succ's entry
+                    succ_parent->left_ = current;
                     succ_parent->is_left_thread_ = true;
                 } else {
                     succ_parent->left_ = succ->right_;
                 }
             }
+            if (!succ->is_right_thread_) {
+                // The successor of succ threads back to it
+                Node* next = succ->right_;
+                while (!next->is_left_thread_) {
+                    next = next->left_;
+                }
+                next->left_ = current;
+            }
 
             current->data_.~pair<const Key, Value>();
             new (&current->data_) std::pair<const Key, Value>(new_key, new_value);
@@ -322,6 +433,36 @@ public:
         return End();
     }
 
+    // The first entry with a key not less than key
+    MapIterator LowerBound(const Key& key) const {
+        return MapIterator(Bound(key, false));
+    }
+
+    // The first entry with a key greater than key
+    MapIterator UpperBound(const Key& key) const {
+        return MapIterator(Bound(key, true));
+    }
+
+    std::pair<MapIterator, MapIterator> EqualRange(const Key& key) const {
+        return {LowerBound(key), UpperBound(key)};
+    }
+
+    // Entries with lo <= key < hi in increasing order. One descent finds each end,
+    // then the walk follows the right threads, so a scan of k entries is O(log n + k)
+    OrderedView Range(const Key& lo, const Key& hi) {
+        if (!comp_(lo, hi)) {
+            return OrderedView(nullptr, nullptr, true);
+        }
+        return OrderedView(Bound(lo, false), Bound(hi, false), true);
+    }
+
+    ConstOrderedView Range(const Key& lo, const Key& hi) const {
+        if (!comp_(lo, hi)) {
+            return ConstOrderedView(nullptr, nullptr, true);
+        }
+        return ConstOrderedView(Bound(lo, false), Bound(hi, false), true);
+    }
+
     ~Map() {
         Clear();
     }
@@ -329,6 +470,8 @@ public:
 private:
     class Node {
         friend class MapIterator;
+        template <bool IsConst>
+        friend class BasicOrderedIterator;
         friend class Map;
 
     public:
@@ -351,6 +494,68 @@ private:
     Node* root_;
     size_t size_;
     Compare comp_;
+
+    // The first node whose key is greater than key for upper, not less than key otherwise
+    Node* Bound(const Key& key, bool upper) const {
+        Node* result = nullptr;
+        Node* current = root_;
+        while (current) {
+            bool go_right = upper ? !comp_(key, current->data_.first) : comp_(current->data_.first, key);
+            if (go_right) {
+                if (current->is_right_thread_) {
+                    break;
+                }
+                current = current->right_;
+            } else {
+                result = current;
+                if (current->is_left_thread_) {
+                    break;
+                }
+                current = current->left_;
+            }
+        }
+        return result;
+    }
+
+    // The leftmost node for leftmost == true, the rightmost one otherwise
+    Node* Edge(bool leftmost) const noexcept {
+        Node* current = root_;
+        if (!current) {
+            return nullptr;
+        }
+        if (leftmost) {
+            while (!current->is_left_thread_) {
+                current = current->left_;
+            }
+        } else {
+            while (!current->is_right_thread_) {
+                current = current->right_;
+            }
+        }
+        return current;
+    }
+
+    static Node* Next(Node* node) noexcept {
+        if (node->is_right_thread_) {
+            return node->right_;
+        }
+        node = node->right_;
+        while (!node->is_left_thread_) {
+            node = node->left_;
+        }
+        return node;
+    }
+
+    static Node* Prev(Node* node) noexcept {
+        if (node->is_left_thread_) {
+            return node->left_;
+        }
+        node = node->left_;
+        while (!node->is_right_thread_) {
+            node = node->right_;
+        }
+        return node;
+    }
 };
 
 namespace std {
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <random>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <fmt/core.h>
@@ -133,6 +135,85 @@ void BM_StdMapClear(benchmark::State& state) {
 }
 
 
+void BM_CustomMapValues(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mp.Values());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapForEach(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    mp.ForEach([&sum](const int& key, int& value) { sum += key + value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CustomMapDescending(benchmark::State& state) {
+  Map<int, int> mp;
+  ConstructRandomMap(mp, state.range(0));
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const auto& [key, value] : mp.Descending()) {
+      sum += key + value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+void ConstructShuffledMap(Map<int, int>& mp, int sz) {
+  std::vector<int> keys(sz);
+  for (int i = 0; i < sz; ++i) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(sz));
+  for (int key : keys) {
+    mp[key] = key;
+  }
+}
+
+// Scans state.range(0) consecutive keys of a map with 1 << 20 keys
+void BM_CustomMapRangeScan(benchmark::State& state) {
+  const int size = 1 << 20;
+  const int width = state.range(0);
+  Map<int, int> mp;
+  ConstructShuffledMap(mp, size);
+  std::mt19937 mt(width);
+  for (auto _ : state) {
+    int lo = static_cast<int>(mt() % (size - width));
+    int64_t sum = 0;
+    for (const auto& [key, value] : mp.Range(lo, lo + width)) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+void BM_CustomMapFullScanFilter(benchmark::State& state) {
+  const int size = 1 << 20;
+  const int width = state.range(0);
+  Map<int, int> mp;
+  ConstructShuffledMap(mp, size);
+  std::mt19937 mt(width);
+  for (auto _ : state) {
+    int lo = static_cast<int>(mt() % (size - width));
+    int64_t sum = 0;
+    for (auto it = mp.Begin(); it != mp.End(); ++it) {
+      if (it->first >= lo && it->first < lo + width) {
+        sum += it->second;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
 BENCHMARK(BM_CustomMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapRandomInsert)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomMapLinearInsert)->Range(1<<10, 1<<15)->Complexity()->Unit(benchmark::kMillisecond);
@@ -141,5 +222,10 @@ BENCHMARK(BM_CustomMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark:
 BENCHMARK(BM_StdMapErase)->Range(1<<10, 1<<17)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_CustomMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_StdMapClear)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapValues)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapForEach)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapDescending)->Range(1<<10, 1<<20)->Complexity()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CustomMapRangeScan)->RangeMultiplier(16)->Range(16, 1<<16);
+BENCHMARK(BM_CustomMapFullScanFilter)->RangeMultiplier(16)->Range(16, 1<<16)->Unit(benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include <chrono>
 #include <future>
 #include <map>
+#include <random>
 #include <iostream>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <fmt/core.h>
 #include <gtest/gtest.h>
@@ -188,6 +192,101 @@ TEST(EmptyMapTest, TreeFromExample) {
   }
 }
 
+TEST(EmptyMapTest, OrderedViews) {
+  Map<int, int> mp;
+  ASSERT_TRUE(mp.Descending().begin() == mp.Descending().end());
+  std::mt19937 mt(5);
+  for (int i = 0; i < 3000; ++i) {
+    mp[static_cast<int>(mt() % 5000)] = i;
+    if (i % 4 == 0) {
+      int key = static_cast<int>(mt() % 5000);
+      if (mp.Find(key) != mp.End()) {
+        mp.Erase(key);
+      }
+    }
+  }
+  std::vector<std::pair<int, int>> ascending;
+  for (auto it = mp.Begin(); it != mp.End(); ++it) {
+    ascending.emplace_back(it->first, it->second);
+  }
+  size_t index = 0;
+  for (const auto& [key, value] : mp.Ascending()) {
+    ASSERT_EQ(key, ascending[index].first);
+    ASSERT_EQ(value, ascending[index].second);
+    ++index;
+  }
+  ASSERT_EQ(index, mp.Size());
+  for (const auto& [key, value] : mp.Descending()) {
+    --index;
+    ASSERT_EQ(key, ascending[index].first);
+    ASSERT_EQ(value, ascending[index].second);
+  }
+  auto descending = mp.Values(false);
+  ASSERT_EQ(descending.size(), mp.Size());
+  mp.ForEach([&](const int& key, int& value) {
+    ASSERT_EQ(key, descending[index].first);
+    value = -value;
+    ++index;
+  }, false);
+  ASSERT_EQ(mp.Begin()->second, -ascending.front().second);
+}
+
+TEST(EmptyMapTest, ConstMapHandsOutConstEntries) {
+  Map<int, int> mp;
+  mp[1] = 10;
+  const auto& view = std::as_const(mp);
+  static_assert(std::is_same_v<decltype(*view.Ascending().begin()), const std::pair<const int, int>&>);
+  static_assert(std::is_same_v<decltype(*view.Range(0, 2).begin()), const std::pair<const int, int>&>);
+  static_assert(std::is_same_v<decltype(*mp.Descending().begin()), std::pair<const int, int>&>);
+  int sum = 0;
+  view.ForEach([&sum](const int& key, auto& value) {
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(value)>>);
+    sum += key + value;
+  });
+  ASSERT_EQ(sum, 11);
+}
+
+TEST(EmptyMapTest, BoundsAndRanges) {
+  Map<int, int> mp;
+  ASSERT_EQ(mp.LowerBound(1), mp.End());
+  ASSERT_TRUE(mp.Range(0, 10).begin() == mp.Range(0, 10).end());
+  std::map<int, int> expected;
+  std::mt19937 mt(9);
+  for (int i = 0; i < 2000; ++i) {
+    int key = static_cast<int>(mt() % 10000);
+    mp[key] = i;
+    expected[key] = i;
+  }
+  for (int i = 0; i < 500; ++i) {
+    int lo = static_cast<int>(mt() % 10200) - 100;
+    int hi = static_cast<int>(mt() % 10200) - 100;
+    auto lower = mp.LowerBound(lo);
+    auto upper = mp.UpperBound(lo);
+    if (expected.lower_bound(lo) == expected.end()) {
+      ASSERT_EQ(lower, mp.End());
+    } else {
+      ASSERT_EQ(lower->first, expected.lower_bound(lo)->first);
+    }
+    if (expected.upper_bound(lo) == expected.end()) {
+      ASSERT_EQ(upper, mp.End());
+    } else {
+      ASSERT_EQ(upper->first, expected.upper_bound(lo)->first);
+    }
+    auto [first, last] = mp.EqualRange(lo);
+    ASSERT_EQ(first, lower);
+    ASSERT_EQ(last, upper);
+    auto it = expected.lower_bound(lo);
+    auto end = lo < hi ? expected.lower_bound(hi) : it;
+    for (const auto& [key, value] : mp.Range(lo, hi)) {
+      ASSERT_NE(it, end);
+      ASSERT_EQ(key, it->first);
+      ASSERT_EQ(value, it->second);
+      ++it;
+    }
+    ASSERT_EQ(it, end);
+  }
+}
+
 TEST_F(MapTest, GetValueUsingOperator) {
   ASSERT_EQ(mp[5], 90);
   ASSERT_EQ(mp[-10], 5);